@@ -0,0 +1,57 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_CLOCK_H_
+#define SRC_CCMETRICS_CLOCK_H_
+
+#include <chrono>
+
+#include "ccmetrics/porting.h"
+
+namespace ccmetrics {
+
+/**
+ * Sources for the timestamps that only need tick or landmark resolution,
+ * such as meter ticks and reservoir decay. Timer durations always use
+ * `std::chrono::steady_clock`.
+ */
+enum class ClockSource {
+    // std::chrono::steady_clock
+    STEADY,
+    // CLOCK_MONOTONIC_COARSE where available, else steady_clock. The default.
+    COARSE,
+    // A timestamp refreshed by a background thread
+    CACHED,
+};
+
+/**
+ * Selects the source of tick and landmark timestamps for all metrics.
+ * Switching sources may step the clock back by up to the coarser source's
+ * resolution, so this is best done once, at startup.
+ *
+ * @param source the clock source
+ * @param refresh the refresh period of the CACHED source
+ */
+CCMETRICS_SYM void setTickClock(ClockSource source,
+    std::chrono::microseconds refresh = std::chrono::microseconds(1000));
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_CLOCK_H_
@@ -22,6 +22,7 @@
 #define SRC_CCMETRICS_COUNTER_H_
 
 #include <cinttypes>
+#include <cstddef>
 
 #include "ccmetrics/porting.h"
 
@@ -29,10 +30,51 @@ namespace ccmetrics {
 
 class CounterImpl;
 
+/** Storage strategies for counter values. */
+enum class CounterType {
+    /** Values are striped across cache lines under contention (default). */
+    STRIPED,
+    /**
+     * Values are kept in a cell per updating thread. Updates never contend,
+     * but reads are linear in the number of threads. Best suited to counters
+     * that are updated at very high rates from a fixed set of threads.
+     */
+    THREAD_LOCAL,
+    /**
+     * Values are kept in a cell per CPU, located with Linux restartable
+     * sequences. Updates rarely contend, and memory is bounded by the number
+     * of CPUs. Falls back to STRIPED where rseq is unavailable.
+     */
+    PER_CPU
+};
+
+/** Construction options for counters. */
+struct CounterOptions {
+    CounterOptions() : type(CounterType::STRIPED), max_stripes(0) { }
+
+    /** The counter storage strategy. */
+    CounterType type;
+
+    /**
+     * For striped counters, the maximum number of stripes (rounded up to a
+     * power of two), or 0 for the global default.
+     */
+    size_t max_stripes;
+};
+
+/**
+ * Set the default maximum number of stripes for striped counters and for
+ * the counts and rates of timers and meters, rounded up to a power of two.
+ * 0 restores the default, which is the hardware concurrency. This only
+ * affects subsequent growth, and is best set at startup.
+ */
+CCMETRICS_SYM void setDefaultMaxStripes(size_t max_stripes);
+
 /** An integral counter metric. */
 class CCMETRICS_SYM Counter {
 public:
     Counter();
+    explicit Counter(CounterOptions const& options);
     ~Counter();
 
     /** Decrement counter by one. */
@@ -0,0 +1,155 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_CYCLE_CLOCK_H_
+#define SRC_CCMETRICS_CYCLE_CLOCK_H_
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <string>
+
+#include "ccmetrics/porting.h"
+
+// The counter is read with inline assembly, or with intrinsics declared
+// here, so that this header need not pull in the intrinsics headers
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define CCMETRICS_HAVE_TSC 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CCMETRICS_HAVE_TSC 1
+extern "C" unsigned __int64 __rdtsc();
+extern "C" unsigned __int64 __rdtscp(unsigned int *aux);
+#pragma intrinsic(__rdtsc)
+#pragma intrinsic(__rdtscp)
+#endif
+
+namespace ccmetrics {
+
+/**
+ * Cheap timestamps for measuring short spans, as in ScopedTimer.
+ *
+ * Reads the CPU's timestamp counter if it is invariant, i.e. ticks at a
+ * constant rate across frequency changes and sleep states (the constant_tsc
+ * and nonstop_tsc flags in /proc/cpuinfo). The cycle rate is calibrated
+ * against steady_clock on first use, which sleeps for a couple of
+ * milliseconds; call `init` to pay for that up front. Elsewhere, ticks are
+ * steady_clock nanoseconds.
+ *
+ * Ticks are only meaningful as differences within a process, and spans
+ * should start and stop on the same core; invariant counters are
+ * synchronized across cores on current hardware, but not by guarantee.
+ */
+class CCMETRICS_SYM CycleClock {
+public:
+    /** @return the tick count at the start of a span. */
+    static int64_t start() {
+#if defined(CCMETRICS_HAVE_TSC)
+        if (mode() == TSC) {
+            return readTsc();
+        }
+#endif
+        return steadyNanos();
+    }
+
+    /**
+     * @return the tick count at the end of a span. Unlike `start`, the read
+     * waits for the span's instructions to complete.
+     */
+    static int64_t stop() {
+#if defined(CCMETRICS_HAVE_TSC)
+        if (mode() == TSC) {
+            return readTscp();
+        }
+#endif
+        return steadyNanos();
+    }
+
+    /** @return the length of `ticks`, in microseconds (truncated). */
+    static int64_t toMicros(int64_t ticks) {
+        return static_cast<int64_t>(ticks * micros_per_tick_);
+    }
+
+    /** @return whether ticks are timestamp counter cycles. */
+    static bool usesTsc() {
+        return mode() == TSC;
+    }
+
+    /**
+     * @return whether a /proc/cpuinfo `flags` line advertises an invariant
+     * timestamp counter. Visible for testing.
+     */
+    static bool invariantTsc(std::string const& flags);
+
+    /**
+     * Detects and calibrates the timestamp counter, once. Optional; the
+     * first span otherwise does so.
+     */
+    static void init();
+private:
+    enum Mode { UNINITIALIZED = 0, STEADY, TSC };
+
+    static int mode() {
+        int mode = mode_.load(std::memory_order_acquire);
+        if (mode == UNINITIALIZED) {
+            // The first span calibrates, unless `init` was called
+            init();
+            mode = mode_.load(std::memory_order_acquire);
+        }
+        return mode;
+    }
+
+#if defined(CCMETRICS_HAVE_TSC)
+    static int64_t readTsc() {
+#if defined(_MSC_VER)
+        return static_cast<int64_t>(__rdtsc());
+#else
+        uint32_t lo, hi;
+        __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi) : : "memory");
+        return static_cast<int64_t>((static_cast<uint64_t>(hi) << 32) | lo);
+#endif
+    }
+
+    // rdtscp waits for preceding instructions, and clobbers ecx
+    static int64_t readTscp() {
+#if defined(_MSC_VER)
+        unsigned int aux;
+        return static_cast<int64_t>(__rdtscp(&aux));
+#else
+        uint32_t lo, hi;
+        __asm__ __volatile__("rdtscp" : "=a"(lo), "=d"(hi) : : "ecx",
+            "memory");
+        return static_cast<int64_t>((static_cast<uint64_t>(hi) << 32) | lo);
+#endif
+    }
+#endif
+
+    static int64_t steadyNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static std::atomic<int> mode_;
+    static double micros_per_tick_; // Written once, before mode_
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_CYCLE_CLOCK_H_
@@ -0,0 +1,87 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_GAUGE_H_
+#define SRC_CCMETRICS_GAUGE_H_
+
+#include <cinttypes>
+#include <functional>
+
+#include "ccmetrics/porting.h"
+
+namespace ccmetrics {
+
+template<typename T>
+class GaugeImpl;
+
+/**
+ * An integral gauge metric, which reports an instantaneous value.
+ *
+ * Gauges are either settable, in which case `set` is a single atomic store,
+ * or backed by a callback that is only evaluated when the gauge is read
+ * (e.g., by a reporter). Callback gauges are the cheapest way to expose
+ * values like queue depths that are already tracked elsewhere; callbacks
+ * must be safe to invoke from the reporting thread and must outlive the
+ * gauge.
+ */
+class CCMETRICS_SYM Gauge {
+public:
+    /** A settable gauge, initially zero. */
+    Gauge();
+
+    /** A gauge whose value is the result of `callback`. */
+    explicit Gauge(std::function<int64_t()> callback);
+    ~Gauge();
+
+    /** Set the value. Has no effect on callback gauges. */
+    void set(int64_t value);
+
+    /** @return the gauge value. */
+    int64_t value();
+private:
+    Gauge(Gauge const&) = delete;
+    Gauge& operator=(Gauge const&) = delete;
+    GaugeImpl<int64_t> *impl_;
+};
+
+/** A floating-point gauge metric; see Gauge. */
+class CCMETRICS_SYM DoubleGauge {
+public:
+    /** A settable gauge, initially zero. */
+    DoubleGauge();
+
+    /** A gauge whose value is the result of `callback`. */
+    explicit DoubleGauge(std::function<double()> callback);
+    ~DoubleGauge();
+
+    /** Set the value. Has no effect on callback gauges. */
+    void set(double value);
+
+    /** @return the gauge value. */
+    double value();
+private:
+    DoubleGauge(DoubleGauge const&) = delete;
+    DoubleGauge& operator=(DoubleGauge const&) = delete;
+    GaugeImpl<double> *impl_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_GAUGE_H_
@@ -0,0 +1,90 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_MAX_GAUGE_H_
+#define SRC_CCMETRICS_MAX_GAUGE_H_
+
+#include <cinttypes>
+
+#include "ccmetrics/porting.h"
+
+namespace ccmetrics {
+
+class StripedMax;
+class StripedMin;
+
+/**
+ * A high-water-mark metric, e.g. for peak in-flight requests or peak queue
+ * depth. Updates are striped across cache lines under contention, and an
+ * update that does not raise the mark is only a load.
+ *
+ * Reporters and serializers only read the mark with `value`, so any number
+ * of them see the same peak. For per-interval peaks, reset the marks in one
+ * place once per interval, e.g. with MetricRegistry::resetWaterMarks after
+ * every reporter has run.
+ */
+class CCMETRICS_SYM MaxGauge {
+public:
+    MaxGauge();
+    ~MaxGauge();
+
+    /** Set value = max(value, x). */
+    void update(int64_t x);
+
+    /** @return the maximum, or 0 if there have been no updates. */
+    int64_t value();
+
+    /**
+     * Reset the mark, returning the maximum (or 0) drained. No concurrent
+     * update is lost.
+     */
+    int64_t getAndReset();
+private:
+    MaxGauge(MaxGauge const&) = delete;
+    MaxGauge& operator=(MaxGauge const&) = delete;
+    StripedMax *impl_;
+};
+
+/** A low-water-mark metric; see MaxGauge. */
+class CCMETRICS_SYM MinGauge {
+public:
+    MinGauge();
+    ~MinGauge();
+
+    /** Set value = min(value, x). */
+    void update(int64_t x);
+
+    /** @return the minimum, or 0 if there have been no updates. */
+    int64_t value();
+
+    /**
+     * Reset the mark, returning the minimum (or 0) drained. No concurrent
+     * update is lost.
+     */
+    int64_t getAndReset();
+private:
+    MinGauge(MinGauge const&) = delete;
+    MinGauge& operator=(MinGauge const&) = delete;
+    StripedMin *impl_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_MAX_GAUGE_H_
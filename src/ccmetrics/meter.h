@@ -21,16 +21,39 @@
 #ifndef SRC_CCMETRICS_METER_H_
 #define SRC_CCMETRICS_METER_H_
 
+#include <vector>
+
 #include "ccmetrics/porting.h"
 
 namespace ccmetrics {
 
 class MeterImpl;
+class MetricRegistryImpl;
+
+/** Construction options for meters, and for the rates of timers. */
+struct MeterOptions {
+    MeterOptions() : tick_seconds(5), rate_windows({ 60, 300, 900 }) { }
+
+    /**
+     * How often the rates take in new events, in seconds; at least 1. Rates
+     * react to changes within a tick or two, so short windows want short
+     * ticks.
+     */
+    int tick_seconds;
+
+    /**
+     * The windows of the tracked rates, in seconds, each at least 1. All
+     * windows share one event buffer, so more windows only cost time when
+     * ticking. Defaults to one, five and fifteen minutes.
+     */
+    std::vector<int> rate_windows;
+};
 
 /** A meter that provides rate estimates. */
 class CCMETRICS_SYM Meter {
 public:
     Meter();
+    explicit Meter(MeterOptions const& options);
     ~Meter();
 
     /** Record an event. */
@@ -47,9 +70,23 @@ public:
 
     /** @return the fifteen minute rate. */
     double fifteenMinuteRate();
+
+    /**
+     * @return the rate over a window of `window_seconds`, or zero if the
+     * meter does not track it.
+     */
+    double rate(int window_seconds);
+
+    /** @return the windows of the tracked rates, in seconds. */
+    std::vector<int> rateWindows() const;
 private:
     Meter(Meter const&) = delete;
     Meter& operator=(Meter const&) = delete;
+
+    // For the registry's background ticker
+    MeterImpl* meterImpl() { return impl_; }
+    friend class MetricRegistryImpl;
+
     MeterImpl *impl_;
 };
 
@@ -21,12 +21,17 @@
 #ifndef SRC_CCMETRICS_METRIC_REGISTRY_H_
 #define SRC_CCMETRICS_METRIC_REGISTRY_H_
 
+#include <functional>
 #include <map>
 #include <string>
 
 #include "ccmetrics/counter.h"
+#include "ccmetrics/gauge.h"
+#include "ccmetrics/max_gauge.h"
 #include "ccmetrics/porting.h"
 #include "ccmetrics/meter.h"
+#include "ccmetrics/snapshot.h"
+#include "ccmetrics/sum.h"
 #include "ccmetrics/timer.h"
 
 namespace ccmetrics {
@@ -54,12 +59,97 @@ public:
     /** @return a new or existing counter. */
     Counter* counter(std::string const& name);
 
-    /** @return a new or existing timer. */
+    /**
+     * @return a new or existing counter. The options only apply if the
+     * counter does not already exist.
+     */
+    Counter* counter(std::string const& name, CounterOptions const& options);
+
+    /**
+     * @return a new or existing timer. New timers use the registry's
+     * default timer options; see `setDefaultTimerOptions`.
+     */
     Timer* timer(std::string const& name);
 
+    /**
+     * @return a new or existing timer. The options only apply if the timer
+     * does not already exist.
+     */
+    Timer* timer(std::string const& name, TimerOptions const& options);
+
+    /**
+     * Sets the options for timers subsequently created without explicit
+     * options, e.g. to choose a registry-wide reservoir at startup. Existing
+     * timers are unaffected.
+     */
+    void setDefaultTimerOptions(TimerOptions const& options);
+
+    /**
+     * @return the combined distribution of every timer whose name starts
+     * with `prefix`, e.g. to roll per-endpoint timers up to a service.
+     */
+    Snapshot mergeTimers(std::string const& prefix) const;
+
     /** @return a new or existing meter. */
     Meter* meter(std::string const& name);
 
+    /**
+     * @return a new or existing meter. The options only apply if the meter
+     * does not already exist.
+     */
+    Meter* meter(std::string const& name, MeterOptions const& options);
+
+    /**
+     * Starts a background thread that ticks the rates of every meter and
+     * timer in the registry once per their tick interval. While it runs, marking a
+     * meter or updating a timer's rates never reads the clock. Without the
+     * ticker, metrics tick lazily when they are accessed. Has no effect if
+     * the ticker is already running.
+     */
+    void startTicker();
+
+    /**
+     * Stops the background ticker, if running, and returns all meters and
+     * timers to lazy ticking. The destructor also stops the ticker.
+     */
+    void stopTicker();
+
+    /** @return a new or existing sum. */
+    Sum* sum(std::string const& name);
+
+    /** @return a new or existing settable gauge. */
+    Gauge* gauge(std::string const& name);
+
+    /**
+     * @return a new or existing gauge. The callback only applies if the
+     * gauge does not already exist.
+     */
+    Gauge* gauge(std::string const& name, std::function<int64_t()> callback);
+
+    /** @return a new or existing settable floating-point gauge. */
+    DoubleGauge* doubleGauge(std::string const& name);
+
+    /**
+     * @return a new or existing floating-point gauge. The callback only
+     * applies if the gauge does not already exist.
+     */
+    DoubleGauge* doubleGauge(std::string const& name,
+        std::function<double()> callback);
+
+    /** @return a new or existing high-water-mark gauge. */
+    MaxGauge* maxGauge(std::string const& name);
+
+    /** @return a new or existing low-water-mark gauge. */
+    MinGauge* minGauge(std::string const& name);
+
+    /**
+     * Resets every high- and low-water mark, starting a new interval.
+     * Reporting never resets marks, so call this once per interval after
+     * all reporters have run, or have one periodic reporter do it; see
+     * `PeriodicReporter::resetWaterMarksAfterReport`.
+     */
+    void resetWaterMarks();
+
     /** @return all registered counter metrics. */
     std::map<std::string, Counter*> counters() const;
 
@@ -68,6 +158,21 @@ public:
 
     /** @return all registered meters. */
     std::map<std::string, Meter*> meters() const;
+
+    /** @return all registered sums. */
+    std::map<std::string, Sum*> sums() const;
+
+    /** @return all registered gauges. */
+    std::map<std::string, Gauge*> gauges() const;
+
+    /** @return all registered floating-point gauges. */
+    std::map<std::string, DoubleGauge*> doubleGauges() const;
+
+    /** @return all registered high-water-mark gauges. */
+    std::map<std::string, MaxGauge*> maxGauges() const;
+
+    /** @return all registered low-water-mark gauges. */
+    std::map<std::string, MinGauge*> minGauges() const;
 private:
     MetricRegistry(MetricRegistry const&) = delete;
     MetricRegistry& operator=(MetricRegistry const&) = delete;
@@ -121,6 +226,38 @@ private:
     ANON_VAR(meter)->mark(value);                               \
     } while (0)
 
+/** Set the named gauge to `value`. */
+#define SET_GAUGE(name, registry, value)                        \
+    do {                                                        \
+    STATIC_DEFINE_ONCE(ccmetrics::Gauge*, ANON_VAR(gauge),      \
+        registry.gauge(name));                                  \
+    ANON_VAR(gauge)->set(value);                                \
+    } while (0)
+
+/** Raise the named high-water mark to `value`, if it is higher. */
+#define UPDATE_MAX_GAUGE(name, registry, value)                 \
+    do {                                                        \
+    STATIC_DEFINE_ONCE(ccmetrics::MaxGauge*, ANON_VAR(gauge),   \
+        registry.maxGauge(name));                               \
+    ANON_VAR(gauge)->update(value);                             \
+    } while (0)
+
+/** Lower the named low-water mark to `value`, if it is lower. */
+#define UPDATE_MIN_GAUGE(name, registry, value)                 \
+    do {                                                        \
+    STATIC_DEFINE_ONCE(ccmetrics::MinGauge*, ANON_VAR(gauge),   \
+        registry.minGauge(name));                               \
+    ANON_VAR(gauge)->update(value);                             \
+    } while (0)
+
+/** Update a sum with `delta`. */
+#define UPDATE_SUM(name, registry, delta)                       \
+    do {                                                        \
+    STATIC_DEFINE_ONCE(ccmetrics::Sum*, ANON_VAR(sum),          \
+        registry.sum(name));                                    \
+    ANON_VAR(sum)->update(delta);                               \
+    } while (0)
+
 } // ccmetrics namespace
 
 #endif // SRC_CCMETRICS_METRIC_REGISTRY_H_
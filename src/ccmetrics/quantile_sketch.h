@@ -0,0 +1,127 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_QUANTILE_SKETCH_H_
+#define SRC_CCMETRICS_QUANTILE_SKETCH_H_
+
+#include <cinttypes>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "ccmetrics/porting.h"
+#include "ccmetrics/snapshot.h"
+
+namespace ccmetrics {
+
+class SketchReservoir;
+
+/**
+ * A mergeable quantile sketch with relative-error guarantees, after
+ * DDSketch [1].
+ *
+ * Values are counted in logarithmic buckets, so that every quantile is
+ * estimated to within the relative accuracy (e.g., 1%) of the true value.
+ * Unlike sampled snapshots, sketches with the same accuracy merge exactly:
+ * the merge of per-shard sketches is the sketch of the combined values.
+ * Sketches can be encoded compactly for merging downstream.
+ *
+ * This is a value type and is not synchronized; timers keep a concurrent
+ * sketch with ReservoirType::SKETCH and export it through Timer::sketch.
+ *
+ * [1] C. Masson, J. Rim and H. Lee. "DDSketch: A Fast and Fully-Mergeable
+ * Quantile Sketch with Relative-Error Guarantees." VLDB, 2019.
+ */
+class CCMETRICS_SYM QuantileSketch {
+public:
+    /** The finest supported relative accuracy. */
+    static const double kMinAccuracy;
+
+    /**
+     * @param accuracy the relative accuracy, in [kMinAccuracy, 1); defaults
+     * to 1%
+     * @throws std::invalid_argument if the accuracy is out of range
+     */
+    explicit QuantileSketch(double accuracy = 0.01);
+
+    /** Record `count` observations of `value`. */
+    void update(int64_t value, int64_t count = 1);
+
+    /**
+     * Fold in the values of `other`.
+     *
+     * @throws std::invalid_argument if the accuracies differ
+     */
+    void merge(QuantileSketch const& other);
+
+    /** @return the number of observations. */
+    int64_t count() const;
+
+    /** @return the relative accuracy. */
+    double accuracy() const { return accuracy_; }
+
+    /**
+     * @return a snapshot of the distribution, with each bucket represented
+     * by a value within the relative accuracy of those it holds.
+     */
+    Snapshot snapshot() const;
+
+    /** @return a compact binary encoding of the sketch. */
+    std::string encode() const;
+
+    /**
+     * @return the sketch encoded in `bytes`.
+     * @throws std::invalid_argument if the encoding is malformed
+     */
+    static QuantileSketch decode(std::string const& bytes);
+private:
+    /** @return the bucket of a positive magnitude. */
+    size_t indexOf(uint64_t magnitude) const;
+
+    /** @return the representative magnitude of a bucket. */
+    int64_t valueAt(size_t index) const;
+
+    struct Buckets;
+    static void mergeBuckets(Buckets *to, Buckets const& from);
+
+    double accuracy_;
+    // 1 / ln(gamma), for gamma = (1 + accuracy) / (1 - accuracy)
+    double multiplier_;
+    double gamma_;
+
+    // Counts for the buckets from `offset` through the highest non-empty
+    // one, so that empty low buckets cost nothing
+    struct Buckets {
+        Buckets() : offset(0) { }
+        size_t offset;
+        std::vector<int64_t> counts;
+    };
+
+    int64_t zero_count_;
+    // Bucket counts, for positive values and negative magnitudes
+    Buckets positive_;
+    Buckets negative_;
+
+    friend class SketchReservoir;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_QUANTILE_SKETCH_H_
@@ -45,6 +45,14 @@ public:
     /** Stop reporting. */
     void stop();
 
+    /**
+     * Reset the water marks of `registry` after each periodic report, so
+     * that every report shows the peaks of its own period; nullptr (the
+     * default) never resets. Only one reporter per registry should reset.
+     * Call before `start`.
+     */
+    void resetWaterMarksAfterReport(MetricRegistry *registry);
+
     /** Implementation-specific report method. */
     virtual void report() NOEXCEPT = 0;
 
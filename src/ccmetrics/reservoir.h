@@ -0,0 +1,50 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_RESERVOIR_H_
+#define SRC_CCMETRICS_RESERVOIR_H_
+
+#include <cinttypes>
+
+#include "ccmetrics/snapshot.h"
+
+namespace ccmetrics {
+
+/**
+ * Interface for the reservoirs that back timer distributions, retaining a
+ * representative sample (or summary) of the recorded values. Custom
+ * reservoirs can be supplied through TimerOptions::reservoir_factory.
+ *
+ * Implementations must support concurrent updates and snapshots.
+ */
+class Reservoir {
+public:
+    virtual ~Reservoir() { }
+
+    /** Record a value. */
+    virtual void update(int64_t value) = 0;
+
+    /** @return a snapshot of the retained values. */
+    virtual Snapshot snapshot() = 0;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_RESERVOIR_H_
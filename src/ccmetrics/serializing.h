@@ -24,7 +24,10 @@
 #include <string>
 
 #include "ccmetrics/counter.h"
+#include "ccmetrics/gauge.h"
+#include "ccmetrics/max_gauge.h"
 #include "ccmetrics/metric_registry.h"
+#include "ccmetrics/sum.h"
 #include "ccmetrics/timer.h"
 
 namespace ccmetrics {
@@ -40,6 +43,26 @@ public:
         return static_cast<Format*>(this)->do_serialize(counter);
     }
 
+    std::string serialize(Sum *sum) {
+        return static_cast<Format*>(this)->do_serialize(sum);
+    }
+
+    std::string serialize(Gauge *gauge) {
+        return static_cast<Format*>(this)->do_serialize(gauge);
+    }
+
+    std::string serialize(DoubleGauge *gauge) {
+        return static_cast<Format*>(this)->do_serialize(gauge);
+    }
+
+    std::string serialize(MaxGauge *gauge) {
+        return static_cast<Format*>(this)->do_serialize(gauge);
+    }
+
+    std::string serialize(MinGauge *gauge) {
+        return static_cast<Format*>(this)->do_serialize(gauge);
+    }
+
     std::string serialize(MetricRegistry *registry) {
         return static_cast<Format*>(this)->do_serialize(registry);
     }
@@ -29,6 +29,11 @@ class JsonSerializer : public Serializer<JsonSerializer> {
 private:
     std::string do_serialize(Timer *timer);
     std::string do_serialize(Counter *counter);
+    std::string do_serialize(Sum *sum);
+    std::string do_serialize(Gauge *gauge);
+    std::string do_serialize(DoubleGauge *gauge);
+    std::string do_serialize(MaxGauge *gauge);
+    std::string do_serialize(MinGauge *gauge);
     std::string do_serialize(MetricRegistry *registry);
     friend class Serializer<JsonSerializer>;
 };
@@ -22,18 +22,79 @@
 #define SRC_CCMETRICS_SNAPSHOT_H_
 
 #include <cinttypes>
+#include <cstddef>
 #include <vector>
 
 #include "ccmetrics/porting.h"
 
 namespace ccmetrics {
 
-/** A snapshot of a distribution. */
+/**
+ * A snapshot of a distribution, either of individual sampled values or of
+ * bucketed values with their observation counts.
+ *
+ * Unsorted values are sorted on first use of an order statistic (`min`, `max`
+ * or `valueAt`), so snapshots are not safe for concurrent use. Prefer
+ * `summarize` when reading several statistics; it avoids the sort entirely.
+ */
 class CCMETRICS_SYM Snapshot {
 public:
+    /** Summary statistics of a snapshot; see `summarize`. */
+    struct Summary {
+        Summary() : count(0), min(0), max(0), mean(0), stdev(0) { }
+
+        size_t count;
+        int64_t min;
+        int64_t max;
+        double mean;
+        double stdev;
+        /** The values at each of the requested quantiles, in order. */
+        std::vector<double> quantiles;
+    };
+
+    /** An empty snapshot. */
+    Snapshot();
+
     Snapshot(std::vector<int64_t> &&values, bool sorted);
+
+    /**
+     * A snapshot of `counts[i]` observations of each `values[i]`. Values
+     * must be sorted in ascending order, and counts must be positive.
+     */
+    Snapshot(std::vector<int64_t> &&values, std::vector<int64_t> &&counts);
     ~Snapshot();
 
+    Snapshot(Snapshot const& other);
+    Snapshot& operator=(Snapshot const& other);
+
+    /**
+     * Moving takes the other snapshot's storage without copying or
+     * allocating, and leaves the other snapshot empty.
+     */
+    Snapshot(Snapshot &&other) NOEXCEPT;
+    Snapshot& operator=(Snapshot &&other) NOEXCEPT;
+
+    /**
+     * @return an empty buffer for building snapshot values or counts,
+     * reusing the storage of destroyed snapshots where possible. Reservoirs
+     * that build their snapshots in these buffers allocate nothing once
+     * reporting reaches a steady state.
+     */
+    static std::vector<int64_t> buffer();
+
+    /** Returns a buffer that will not be passed to a snapshot for reuse. */
+    static void recycle(std::vector<int64_t> &&buffer);
+
+    /**
+     * @return the combined distribution of `snapshots`, built with a k-way
+     * merge of their (sorted) values. The result is weighted if any input is;
+     * unsorted inputs are sorted first.
+     */
+    static Snapshot merge(std::vector<Snapshot> const& snapshots);
+
+    /** @return the number of observations in the snapshot. */
+    size_t size() const;
+
     /** @return the mean. */
     double mean() const;
 
@@ -41,20 +102,10 @@ public:
     double stdev() const;
 
     /** @return the minimum value. */
-    int64_t min() const {
-        if (!values_->empty()) {
-            return values_->front();
-        }
-        return 0;
-    }
+    int64_t min() const;
 
     /** @return the maximum value. */
-    int64_t max() const {
-        if (!values_->empty()) {
-            return values_->back();
-        }
-        return 0;
-    }
+    int64_t max() const;
 
     /** @return the median. */
     double median() const { return valueAt(0.5); }
@@ -73,8 +124,25 @@ public:
 
     /** @return the valuue of the distribution at the quantile [0, 1] */
     double valueAt(double quantile) const;
+
+    /**
+     * @return the count, min, max, mean and standard deviation, computed in
+     * a single pass, and the values at each of `quantiles` (in [0, 1]).
+     * Quantiles of unsorted values are found by selection rather than by
+     * sorting.
+     */
+    Summary summarize(std::vector<double> const& quantiles) const;
 private:
+    /** @return the value at (zero-based) rank `rank` of the observations. */
+    int64_t nth(size_t rank) const;
+
+    /** Sorts the values if they were not sorted on construction. */
+    void ensureSorted() const;
+
     std::vector<int64_t> *values_;
+    // Cumulative counts of the values, or null if each was observed once
+    std::vector<int64_t> *ranks_;
+    mutable bool sorted_;
 };
 
 } // ccmetrics namespace
@@ -0,0 +1,53 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_CCMETRICS_SUM_H_
+#define SRC_CCMETRICS_SUM_H_
+
+#include "ccmetrics/porting.h"
+
+namespace ccmetrics {
+
+class StripedDouble;
+
+/**
+ * A floating-point sum metric, for accumulating fractional quantities
+ * (e.g., CPU seconds) without truncation. Updates are striped across cache
+ * lines under contention, as for the default counter.
+ */
+class CCMETRICS_SYM Sum {
+public:
+    Sum();
+    ~Sum();
+
+    /** Set value += delta. */
+    void update(double delta);
+
+    /** @return the sum. */
+    double value();
+private:
+    Sum(Sum const&) = delete;
+    Sum& operator=(Sum const&) = delete;
+    StripedDouble *impl_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_CCMETRICS_SUM_H_
@@ -23,14 +23,119 @@
 
 #include <cinttypes>
 #include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
 
+#include "ccmetrics/cycle_clock.h"
+#include "ccmetrics/meter.h"
 #include "ccmetrics/porting.h"
+#include "ccmetrics/quantile_sketch.h"
+#include "ccmetrics/reservoir.h"
 #include "ccmetrics/snapshot.h"
 
 namespace ccmetrics {
 
+class MeterImpl;
+class MetricRegistryImpl;
 class TimerImpl;
 
+/** Reservoirs for estimating the distribution of timer durations. */
+enum class ReservoirType {
+    /**
+     * A forward-decaying sample of `reservoir_size` values, biased towards
+     * recent values by `decay_alpha` (default).
+     */
+    EXPONENTIAL,
+    /**
+     * Log-linear buckets counting every value with fixed relative precision.
+     * Recording is allocation-free and far cheaper than sampling; memory is
+     * fixed by the range and precision.
+     */
+    HDR,
+    /**
+     * Log-linear buckets as for HDR, recorded per thread without touching
+     * shared cache lines. Each snapshot covers exactly the durations recorded
+     * since the previous one, at the cost of memory for every updating thread.
+     */
+    INTERVAL,
+    /**
+     * Log-linear buckets as for HDR, kept per second for a sliding window of
+     * the last `window_seconds`; values age out of snapshots exactly.
+     */
+    SLIDING_WINDOW,
+    /**
+     * A uniform random sample (Vitter's Algorithm R) of `reservoir_size`
+     * values over all time, in a fixed array; no decay.
+     */
+    UNIFORM,
+    /** The last `reservoir_size` values, in a fixed ring buffer. */
+    SLIDING_COUNT,
+    /**
+     * A mergeable QuantileSketch of every value, with `sketch_accuracy`
+     * relative error; see Timer::sketch.
+     */
+    SKETCH
+};
+
+/** Construction options for timers. */
+struct TimerOptions {
+    TimerOptions() : reservoir(ReservoirType::EXPONENTIAL),
+        hdr_highest(3600LL * 1000 * 1000), hdr_significant_digits(2),
+        window_seconds(60), reservoir_size(1028), decay_alpha(0.015),
+        sketch_accuracy(0.01) { }
+
+    /** The reservoir type. */
+    ReservoirType reservoir;
+
+    /**
+     * For bucketed (HDR, INTERVAL and SLIDING_WINDOW) reservoirs, the
+     * highest trackable duration (in us); larger durations are clamped to
+     * it. Defaults to one hour.
+     */
+    int64_t hdr_highest;
+
+    /** For bucketed reservoirs, the decimal digits of precision, in [1, 5]. */
+    int hdr_significant_digits;
+
+    /**
+     * For SLIDING_WINDOW reservoirs, the window length in seconds. Each
+     * second of the window holds its own buckets.
+     */
+    int window_seconds;
+
+    /**
+     * For EXPONENTIAL, UNIFORM and SLIDING_COUNT reservoirs, the number of
+     * values kept. Each EXPONENTIAL value costs a skip list node, roughly
+     * 100 bytes.
+     */
+    size_t reservoir_size;
+
+    /**
+     * For EXPONENTIAL reservoirs, the forward decay factor (per second).
+     * Larger values bias the sample more strongly towards recent values;
+     * the default weights it to roughly the last five minutes, and zero
+     * gives a uniform sample.
+     */
+    double decay_alpha;
+
+    /**
+     * For SKETCH reservoirs, the relative accuracy, in
+     * [QuantileSketch::kMinAccuracy, 1). The reservoir's memory grows
+     * inversely with it: about 17KB at the default 1%.
+     */
+    double sketch_accuracy;
+
+    /** The tick interval and windows of the timer's rates. */
+    MeterOptions rates;
+
+    /**
+     * If set, creates the timer's reservoir, which the timer takes ownership
+     * of; the other reservoir options are then ignored.
+     */
+    std::function<Reservoir*()> reservoir_factory;
+};
+
 /**
  * A timer metric that reports aggregate statistics of recorded event durations
  * and throughput estimates.
@@ -38,6 +143,7 @@ class TimerImpl;
 class CCMETRICS_SYM Timer {
 public:
     Timer();
+    explicit Timer(TimerOptions const& options);
     ~Timer();
 
     /** Record an event duration (in ms). */
@@ -55,25 +161,48 @@ public:
     /** @return the fifteen minute rate, in operations / s. */
     double fifteenMinuteRate();
 
+    /**
+     * @return the rate over a window of `window_seconds`, in operations / s,
+     * or zero if the timer does not track it; see TimerOptions::rates.
+     */
+    double rate(int window_seconds);
+
+    /** @return the windows of the tracked rates, in seconds. */
+    std::vector<int> rateWindows() const;
+
     /** @return a snapshot of the distribution of durations. */
     Snapshot snapshot();
+
+    /**
+     * @return a mergeable sketch of the distribution of durations.
+     * @throws std::logic_error unless the timer has a SKETCH reservoir
+     */
+    QuantileSketch sketch();
 private:
     Timer(Timer const&) = delete;
     Timer& operator=(Timer const&) = delete;
+
+    // For the registry's background ticker
+    MeterImpl* meterImpl();
+    friend class MetricRegistryImpl;
+
     TimerImpl *impl_;
 };
 
+/**
+ * Records the duration of its scope (in us). Spans are measured with the
+ * CycleClock, so timing costs a timestamp counter read at either end where
+ * the counter is reliable.
+ */
 class ScopedTimer {
 public:
     explicit ScopedTimer(Timer *t)
-        : start_(std::chrono::steady_clock::now()), t_(t) { }
+        : start_(CycleClock::start()), t_(t) { }
     ~ScopedTimer() {
-        auto delta_us = std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::steady_clock::now() - start_);
-        t_->update(delta_us.count());
+        t_->update(CycleClock::toMicros(CycleClock::stop() - start_));
     }
 private:
-    decltype(std::chrono::steady_clock::now()) start_;
+    int64_t start_;
     Timer *t_;
 };
 
@@ -63,10 +63,23 @@ public:
     /** @return the first key, _or a default-constructed key if empty_. */
     Key firstKey();
 
+    /**
+     * Removes the first entry, storing its key and value in the (optional)
+     * out-parameters. Cheaper than `firstKey` followed by `erase`: the head
+     * node is never deleted, so the first entry can be unlinked without a
+     * search from the top of the index.
+     *
+     * @return whether an entry was removed (false iff the map was empty).
+     */
+    bool pollFirst(Key *key = nullptr, Value *value = nullptr);
+
     /** @return a weakly consistent snapshot of the values in the map.
      *          _Note carefully_ that the values may not be in key order. */
     std::vector<Value> values();
 
+    /** Appends the values to `out`, as for `values()`. */
+    void values(std::vector<Value> *out);
+
     /** @return a weakly consitent snapshot of entries in the map. */
     std::vector<std::pair<Key, Value>> entries();
 private:
@@ -145,8 +158,11 @@ private:
     /** Takes a snapshot for nodes around `key`; see above. */
     FindResult find(Key const& key);
 
+    /** Unlinks the dead node `cur`, hazard-guarded by hp1; see pollFirst. */
+    void unlinkFirst(Node *cur);
+
     template<typename Ret, typename Func>
-    Ret extractor(Func const& f);
+    void extractor(Ret *ret, Func const& f);
 
     Node *head_;
     int height_; // XXX atomic
@@ -414,11 +430,90 @@ Key ConcurrentSkipListMap<Key, Value>::firstKey() {
     return ret;
 }
 
+// pollFirst specializes erase for the head successor. Marking is identical to
+// erase, but because the head node is never marked its `next_i` pointers are
+// always a consistent `prev` for a first node, so no Find is needed to take a
+// snapshot. Losing the level-0 mark to a concurrent eraser just means helping
+// to unlink the dead node and retrying with the new first node.
+template<typename Key, typename Value>
+bool ConcurrentSkipListMap<Key, Value>::pollFirst(Key *key, Value *value) {
+    auto& hp = *smr_.hp;
+
+    for (;;) {
+        Node *cur = hp.loadAndSetHazard(head_->next_[0], 1); // hp1
+        if (marked0(cur)) {
+            continue;
+        }
+        if (!cur) {
+            hp.clearHazard(1);
+            return false;
+        }
+
+        bool marked_0 = false;
+        for (int i = cur->height - 1; i >= 0; --i) {
+            Node *nexti = cur->next_[i];
+            while (!cur->next_[i].compare_exchange_strong(nexti,
+                    mark(nexti))) {
+                nexti = cur->next_[i];
+            }
+            if (i == 0 && nexti == clear(nexti)) {
+                marked_0 = true; // Linearization point; see erase
+            }
+        }
+
+        if (marked_0) {
+            if (key) {
+                *key = cur->key;
+            }
+            if (value) {
+                *value = cur->value;
+            }
+        }
+
+        unlinkFirst(cur);
+
+        if (marked_0) {
+            return true;
+        }
+    }
+}
+
+// Unlinks a dead node directly from the head at every level where the head
+// still points at it. If that leaves the node referenced (a smaller key was
+// inserted ahead of it, a concurrent Find got to a level first, or index
+// insertion for the node is still in flight) we fall back to the Find that
+// erase uses, which unlinks marked nodes on its descent path.
+template<typename Key, typename Value>
+void ConcurrentSkipListMap<Key, Value>::unlinkFirst(Node *cur) {
+    auto& hp = *smr_.hp;
+    const Key key = cur->key;
+
+    bool retire = false;
+    for (int i = cur->height - 1; i >= 0 && !retire; --i) {
+        // Dead node; next pointers are immutable
+        Node *nexti = cur->next_[i].load(std::memory_order_relaxed);
+        Node *expected = cur;
+        if (head_->next_[i].compare_exchange_strong(expected, clear(nexti))) {
+            retire = --cur->link_count == 0;
+        }
+    }
+
+    hp.clearHazard(1);
+    if (retire) {
+        hp.retireNode(cur);
+        return;
+    }
+
+    find(key);
+    hp.clearHazard(0);
+    hp.clearHazard(1);
+    hp.clearHazard(2);
+}
+
 template<typename Key, typename Value>
 template<typename Ret, typename Func>
-Ret ConcurrentSkipListMap<Key, Value>::extractor(Func const& f) {
+void ConcurrentSkipListMap<Key, Value>::extractor(Ret *ret, Func const& f) {
     auto& hp = *smr_.hp;
-    Ret ret;
 
     // This algorithm is similar to Find on level-0 (MM's Find), but restarts
     // only when *both* prev and next are inconsistent.
@@ -432,7 +527,7 @@ try_again:
             break;
         }
 
-        ret.push_back(f(cur));
+        ret->push_back(f(cur));
 
         next = hp.loadAndSetHazard(cur->next_[0], 0); // hp0
         while (marked0(next)) {
@@ -459,13 +554,18 @@ try_again:
     hp.clearHazard(0);
     hp.clearHazard(1);
     hp.clearHazard(2);
+}
 
+template<typename Key, typename Value>
+std::vector<Value> ConcurrentSkipListMap<Key, Value>::values() {
+    std::vector<Value> ret;
+    values(&ret);
     return ret;
 }
 
 template<typename Key, typename Value>
-std::vector<Value> ConcurrentSkipListMap<Key, Value>::values() {
-    return extractor<std::vector<Value>>([](Node *n) -> Value {
+void ConcurrentSkipListMap<Key, Value>::values(std::vector<Value> *out) {
+    extractor(out, [](Node *n) -> Value {
             return n->value;
         });
 }
@@ -473,10 +573,11 @@ std::vector<Value> ConcurrentSkipListMap<Key, Value>::values() {
 template<typename Key, typename Value>
 std::vector<std::pair<Key, Value>>
 ConcurrentSkipListMap<Key, Value>::entries() {
-    return extractor<std::vector<std::pair<Key, Value>>>(
-        [](Node *n) -> std::pair<Key, Value> {
+    std::vector<std::pair<Key, Value>> ret;
+    extractor(&ret, [](Node *n) -> std::pair<Key, Value> {
             return std::make_pair(n->key, n->value);
         });
+    return ret;
 }
 
 template<typename Key, typename Value>
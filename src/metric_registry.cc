@@ -20,13 +20,17 @@
 
 #include "ccmetrics/metric_registry.h"
 
+#include <chrono>
 #include <utility>
+#include <vector>
 
 #include "metric_registry_impl.h"
+#include "metrics/meter_impl.h"
+#include "metrics/tick_clock.h"
 
 namespace ccmetrics {
 
-MetricRegistryImpl::MetricRegistryImpl() { }
+MetricRegistryImpl::MetricRegistryImpl() : ticker_running_(false) { }
 
 namespace {
 template<typename T>
@@ -37,6 +41,18 @@ void deleteMetrics(MetricMap<T> &mm) {
     }
 }
 
+template<typename T, typename... Args>
+T* getOrCreate(MetricMap<T> &mm, std::string const& name, Args&&... args) {
+    std::lock_guard<std::mutex> lock(mm.mutex);
+    auto exist = mm.metrics.find(name);
+    if (exist != mm.metrics.end()) {
+        return exist->second;
+    }
+    T *ret = new T(std::forward<Args>(args)...);
+    mm.metrics.insert(std::make_pair(name, ret));
+    return ret;
+}
+
 template<typename T>
 std::map<std::string, T*> toMap(MetricMap<T> const& mm) {
     std::map<std::string, T*> ret;
@@ -49,41 +65,177 @@ std::map<std::string, T*> toMap(MetricMap<T> const& mm) {
 } // unnamed namespace
 
 MetricRegistryImpl::~MetricRegistryImpl() {
+    stopTicker();
     deleteMetrics(counters_);
     deleteMetrics(timers_);
+    deleteMetrics(meters_);
+    deleteMetrics(sums_);
+    deleteMetrics(gauges_);
+    deleteMetrics(double_gauges_);
+    deleteMetrics(max_gauges_);
+    deleteMetrics(min_gauges_);
 }
 
 Counter* MetricRegistryImpl::counter(std::string const& name) {
-    std::lock_guard<std::mutex> lock(counters_.mutex);
-    auto exist = counters_.metrics.find(name);
-    if (exist != counters_.metrics.end()) {
-        return exist->second;
-    }
-    Counter *ret = new Counter();
-    counters_.metrics.insert(std::make_pair(name, ret));
-    return ret;
+    return counter(name, CounterOptions());
+}
+
+Counter* MetricRegistryImpl::counter(std::string const& name,
+        CounterOptions const& options) {
+    return getOrCreate(counters_, name, options);
 }
 
 Timer* MetricRegistryImpl::timer(std::string const& name) {
-    std::lock_guard<std::mutex> lock(timers_.mutex);
-    auto exist = timers_.metrics.find(name);
-    if (exist != timers_.metrics.end()) {
-        return exist->second;
+    // The defaults are read under the same lock that guards them
+    return getOrCreate(timers_, name, default_timer_options_);
+}
+
+Timer* MetricRegistryImpl::timer(std::string const& name,
+        TimerOptions const& options) {
+    return getOrCreate(timers_, name, options);
+}
+
+Snapshot MetricRegistryImpl::mergeTimers(std::string const& prefix) const {
+    std::vector<Timer*> matching;
+    {
+        std::lock_guard<std::mutex> lock(timers_.mutex);
+        for (auto& entry : timers_.metrics) {
+            if (entry.first.compare(0, prefix.size(), prefix) == 0) {
+                matching.push_back(entry.second);
+            }
+        }
     }
-    Timer *ret = new Timer();
-    timers_.metrics.insert(std::make_pair(name, ret));
-    return ret;
+
+    // Timers live as long as the registry, so snapshot outside the lock.
+    // Each timer's values are copied once, into its snapshot, and then
+    // merged directly into the result.
+    std::vector<Snapshot> snapshots;
+    snapshots.reserve(matching.size());
+    for (Timer *timer : matching) {
+        snapshots.push_back(timer->snapshot());
+    }
+    return Snapshot::merge(snapshots);
+}
+
+void MetricRegistryImpl::setDefaultTimerOptions(TimerOptions const& options) {
+    std::lock_guard<std::mutex> lock(timers_.mutex);
+    default_timer_options_ = options;
 }
 
 Meter* MetricRegistryImpl::meter(std::string const& name) {
-    std::lock_guard<std::mutex> lock(meters_.mutex);
-    auto exist = meters_.metrics.find(name);
-    if (exist != meters_.metrics.end()) {
-        return exist->second;
+    return getOrCreate(meters_, name);
+}
+
+Meter* MetricRegistryImpl::meter(std::string const& name,
+        MeterOptions const& options) {
+    return getOrCreate(meters_, name, options);
+}
+
+void MetricRegistryImpl::startTicker() {
+    std::lock_guard<std::mutex> lock(ticker_mutex_);
+    if (ticker_running_) {
+        return;
+    }
+    ticker_running_ = true;
+    forEachMeter([](MeterImpl *meter) -> void {
+            meter->setTickedExternally(true);
+        });
+    ticker_ = std::thread([this]() -> void { tickLoop(); });
+}
+
+void MetricRegistryImpl::stopTicker() {
+    {
+        std::lock_guard<std::mutex> lock(ticker_mutex_);
+        if (!ticker_running_) {
+            return;
+        }
+        ticker_running_ = false;
+    }
+    ticker_cv_.notify_all();
+    ticker_.join();
+    forEachMeter([](MeterImpl *meter) -> void {
+            meter->setTickedExternally(false);
+        });
+}
+
+void MetricRegistryImpl::tickLoop() {
+    // Tick intervals are whole seconds, so checking every second keeps
+    // each metric's ticks on time; metrics not due skip their tick
+    const std::chrono::seconds interval(1);
+    auto next = std::chrono::steady_clock::now() + interval;
+
+    std::unique_lock<std::mutex> lock(ticker_mutex_);
+    while (ticker_running_) {
+        if (ticker_cv_.wait_until(lock, next) != std::cv_status::timeout) {
+            continue; // Spurious wakeup or stop
+        }
+        lock.unlock();
+        // Metrics created since the last pass switch over here
+        auto now = TickClock::now();
+        forEachMeter([now](MeterImpl *meter) -> void {
+                meter->setTickedExternally(true);
+                meter->tickExternally(now);
+            });
+        next += interval;
+        lock.lock();
+    }
+}
+
+void MetricRegistryImpl::forEachMeter(
+        std::function<void(MeterImpl*)> const& fn) {
+    {
+        std::lock_guard<std::mutex> lock(meters_.mutex);
+        for (auto& entry : meters_.metrics) {
+            fn(entry.second->meterImpl());
+        }
+    }
+    std::lock_guard<std::mutex> lock(timers_.mutex);
+    for (auto& entry : timers_.metrics) {
+        fn(entry.second->meterImpl());
+    }
+}
+
+Sum* MetricRegistryImpl::sum(std::string const& name) {
+    return getOrCreate(sums_, name);
+}
+
+Gauge* MetricRegistryImpl::gauge(std::string const& name) {
+    return getOrCreate(gauges_, name);
+}
+
+Gauge* MetricRegistryImpl::gauge(std::string const& name,
+        std::function<int64_t()> callback) {
+    return getOrCreate(gauges_, name, std::move(callback));
+}
+
+DoubleGauge* MetricRegistryImpl::doubleGauge(std::string const& name) {
+    return getOrCreate(double_gauges_, name);
+}
+
+DoubleGauge* MetricRegistryImpl::doubleGauge(std::string const& name,
+        std::function<double()> callback) {
+    return getOrCreate(double_gauges_, name, std::move(callback));
+}
+
+MaxGauge* MetricRegistryImpl::maxGauge(std::string const& name) {
+    return getOrCreate(max_gauges_, name);
+}
+
+MinGauge* MetricRegistryImpl::minGauge(std::string const& name) {
+    return getOrCreate(min_gauges_, name);
+}
+
+void MetricRegistryImpl::resetWaterMarks() {
+    {
+        std::lock_guard<std::mutex> lock(max_gauges_.mutex);
+        for (auto& entry : max_gauges_.metrics) {
+            entry.second->getAndReset();
+        }
+    }
+    std::lock_guard<std::mutex> lock(min_gauges_.mutex);
+    for (auto& entry : min_gauges_.metrics) {
+        entry.second->getAndReset();
     }
-    Meter *ret = new Meter();
-    meters_.metrics.insert(std::make_pair(name, ret));
-    return ret;
 }
 
 std::map<std::string, Counter*> MetricRegistryImpl::counters() const {
@@ -98,6 +250,26 @@ std::map<std::string, Meter*> MetricRegistryImpl::meters() const {
     return toMap(meters_);
 }
 
+std::map<std::string, Sum*> MetricRegistryImpl::sums() const {
+    return toMap(sums_);
+}
+
+std::map<std::string, Gauge*> MetricRegistryImpl::gauges() const {
+    return toMap(gauges_);
+}
+
+std::map<std::string, DoubleGauge*> MetricRegistryImpl::doubleGauges() const {
+    return toMap(double_gauges_);
+}
+
+std::map<std::string, MaxGauge*> MetricRegistryImpl::maxGauges() const {
+    return toMap(max_gauges_);
+}
+
+std::map<std::string, MinGauge*> MetricRegistryImpl::minGauges() const {
+    return toMap(min_gauges_);
+}
+
 //
 // MetricRegistry
 //
@@ -107,20 +279,85 @@ MetricRegistry::~MetricRegistry() { delete impl_; }
 Counter* MetricRegistry::counter(std::string const& name) {
     return impl_->counter(name);
 }
+Counter* MetricRegistry::counter(std::string const& name,
+        CounterOptions const& options) {
+    return impl_->counter(name, options);
+}
 std::map<std::string, Counter*> MetricRegistry::counters() const {
     return impl_->counters();
 }
 Timer* MetricRegistry::timer(std::string const& name) {
     return impl_->timer(name);
 }
+Timer* MetricRegistry::timer(std::string const& name,
+        TimerOptions const& options) {
+    return impl_->timer(name, options);
+}
+void MetricRegistry::setDefaultTimerOptions(TimerOptions const& options) {
+    impl_->setDefaultTimerOptions(options);
+}
+Snapshot MetricRegistry::mergeTimers(std::string const& prefix) const {
+    return impl_->mergeTimers(prefix);
+}
 Meter* MetricRegistry::meter(std::string const& name) {
     return impl_->meter(name);
 }
+Meter* MetricRegistry::meter(std::string const& name,
+        MeterOptions const& options) {
+    return impl_->meter(name, options);
+}
+void MetricRegistry::startTicker() {
+    impl_->startTicker();
+}
+void MetricRegistry::stopTicker() {
+    impl_->stopTicker();
+}
 std::map<std::string, Timer*> MetricRegistry::timers() const {
     return impl_->timers();
 }
 std::map<std::string, Meter*> MetricRegistry::meters() const {
     return impl_->meters();
 }
+Sum* MetricRegistry::sum(std::string const& name) {
+    return impl_->sum(name);
+}
+std::map<std::string, Sum*> MetricRegistry::sums() const {
+    return impl_->sums();
+}
+Gauge* MetricRegistry::gauge(std::string const& name) {
+    return impl_->gauge(name);
+}
+Gauge* MetricRegistry::gauge(std::string const& name,
+        std::function<int64_t()> callback) {
+    return impl_->gauge(name, std::move(callback));
+}
+DoubleGauge* MetricRegistry::doubleGauge(std::string const& name) {
+    return impl_->doubleGauge(name);
+}
+DoubleGauge* MetricRegistry::doubleGauge(std::string const& name,
+        std::function<double()> callback) {
+    return impl_->doubleGauge(name, std::move(callback));
+}
+std::map<std::string, Gauge*> MetricRegistry::gauges() const {
+    return impl_->gauges();
+}
+std::map<std::string, DoubleGauge*> MetricRegistry::doubleGauges() const {
+    return impl_->doubleGauges();
+}
+MaxGauge* MetricRegistry::maxGauge(std::string const& name) {
+    return impl_->maxGauge(name);
+}
+MinGauge* MetricRegistry::minGauge(std::string const& name) {
+    return impl_->minGauge(name);
+}
+void MetricRegistry::resetWaterMarks() {
+    impl_->resetWaterMarks();
+}
+std::map<std::string, MaxGauge*> MetricRegistry::maxGauges() const {
+    return impl_->maxGauges();
+}
+std::map<std::string, MinGauge*> MetricRegistry::minGauges() const {
+    return impl_->minGauges();
+}
 
 } // ccmetrics namespace
@@ -21,13 +21,19 @@
 #ifndef SRC_METRIC_REGISTRY_IMPL_H_
 #define SRC_METRIC_REGISTRY_IMPL_H_
 
+#include <condition_variable>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "ccmetrics/counter.h"
+#include "ccmetrics/gauge.h"
+#include "ccmetrics/max_gauge.h"
 #include "ccmetrics/meter.h"
+#include "ccmetrics/sum.h"
 #include "ccmetrics/timer.h"
 
 namespace ccmetrics {
@@ -46,12 +52,73 @@ public:
     /** @return a new or existing counter. */
     Counter* counter(std::string const& name);
 
+    /**
+     * @return a new or existing counter. The options only apply if the
+     * counter does not already exist.
+     */
+    Counter* counter(std::string const& name, CounterOptions const& options);
+
     /** @return a new or existing timer. */
     Timer* timer(std::string const& name);
 
+    /**
+     * @return a new or existing timer. The options only apply if the timer
+     * does not already exist.
+     */
+    Timer* timer(std::string const& name, TimerOptions const& options);
+
+    /** @return the merged snapshots of timers starting with `prefix`. */
+    Snapshot mergeTimers(std::string const& prefix) const;
+
+    /** Sets the options for timers created without explicit options. */
+    void setDefaultTimerOptions(TimerOptions const& options);
+
     /** @return a new or existing meter. */
     Meter* meter(std::string const& naem);
 
+    /**
+     * @return a new or existing meter. The options only apply if the meter
+     * does not already exist.
+     */
+    Meter* meter(std::string const& name, MeterOptions const& options);
+
+    /** Starts ticking meters and timers from a background thread. */
+    void startTicker();
+
+    /** Stops the background ticker and resumes lazy ticking. */
+    void stopTicker();
+
+    /** @return a new or existing sum. */
+    Sum* sum(std::string const& name);
+
+    /** @return a new or existing settable gauge. */
+    Gauge* gauge(std::string const& name);
+
+    /**
+     * @return a new or existing gauge. The callback only applies if the
+     * gauge does not already exist.
+     */
+    Gauge* gauge(std::string const& name, std::function<int64_t()> callback);
+
+    /** @return a new or existing settable floating-point gauge. */
+    DoubleGauge* doubleGauge(std::string const& name);
+
+    /**
+     * @return a new or existing floating-point gauge. The callback only
+     * applies if the gauge does not already exist.
+     */
+    DoubleGauge* doubleGauge(std::string const& name,
+        std::function<double()> callback);
+
+    /** @return a new or existing high-water-mark gauge. */
+    MaxGauge* maxGauge(std::string const& name);
+
+    /** @return a new or existing low-water-mark gauge. */
+    MinGauge* minGauge(std::string const& name);
+
+    /** Resets every high- and low-water mark. */
+    void resetWaterMarks();
+
     /** @return all registered counter metrics. */
     std::map<std::string, Counter*> counters() const;
 
@@ -60,10 +127,42 @@ public:
 
     /** @return all registered meters. */
     std::map<std::string, Meter*> meters() const;
+
+    /** @return all registered sums. */
+    std::map<std::string, Sum*> sums() const;
+
+    /** @return all registered gauges. */
+    std::map<std::string, Gauge*> gauges() const;
+
+    /** @return all registered floating-point gauges. */
+    std::map<std::string, DoubleGauge*> doubleGauges() const;
+
+    /** @return all registered high-water-mark gauges. */
+    std::map<std::string, MaxGauge*> maxGauges() const;
+
+    /** @return all registered low-water-mark gauges. */
+    std::map<std::string, MinGauge*> minGauges() const;
 private:
+    /** Body of the ticker thread. */
+    void tickLoop();
+
+    /** Applies `fn` to the rates of every meter and timer. */
+    void forEachMeter(std::function<void(MeterImpl*)> const& fn);
+
     MetricMap<Counter> counters_;
     MetricMap<Timer> timers_;
+    TimerOptions default_timer_options_; // Guarded by timers_.mutex
     MetricMap<Meter> meters_;
+    MetricMap<Sum> sums_;
+    MetricMap<Gauge> gauges_;
+    MetricMap<DoubleGauge> double_gauges_;
+    MetricMap<MaxGauge> max_gauges_;
+    MetricMap<MinGauge> min_gauges_;
+
+    std::mutex ticker_mutex_;
+    std::condition_variable ticker_cv_;
+    bool ticker_running_; // Guarded by ticker_mutex_
+    std::thread ticker_;
 };
 
 } // ccmetrics namespace
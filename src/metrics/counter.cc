@@ -24,7 +24,35 @@
 
 namespace ccmetrics {
 
-Counter::Counter() : impl_(new CounterImpl()) { }
+namespace {
+CounterImpl* mkCounterImpl(CounterOptions const& options) {
+    switch (options.type) {
+    case CounterType::THREAD_LOCAL:
+        return new BasicCounterImpl<ThreadLocal64>();
+    case CounterType::PER_CPU:
+        if (PerCpu64::available()) {
+            return new BasicCounterImpl<PerCpu64>();
+        }
+        // Fall back to striping
+        break;
+    case CounterType::STRIPED:
+    default:
+        break;
+    }
+
+    auto *ret = new BasicCounterImpl<Striped64>();
+    ret->accumulator().setMaxStripes(options.max_stripes);
+    return ret;
+}
+} // unnamed namespace
+
+void setDefaultMaxStripes(size_t max_stripes) {
+    Striped64::setDefaultMaxStripes(max_stripes);
+}
+
+Counter::Counter() : impl_(mkCounterImpl(CounterOptions())) { }
+Counter::Counter(CounterOptions const& options)
+    : impl_(mkCounterImpl(options)) { }
 Counter::~Counter() { delete impl_; }
 int64_t Counter::value() { return impl_->value(); }
 void Counter::inc() { impl_->inc(); }
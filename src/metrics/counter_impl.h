@@ -21,28 +21,46 @@
 #ifndef SRC_METRICS_COUNTER_IMPL_H_
 #define SRC_METRICS_COUNTER_IMPL_H_
 
+#include "per_cpu_int64.h"
 #include "striped_int64.h"
+#include "thread_local_int64.h"
 
 namespace ccmetrics {
 
 /*
- * Implementation of a counter that uses a sharded reservior to implement
- * concurrent value updates w/ reduced contention. Concurrent read and
- * modification of this counter can yield inconsitent results; this is
- * an acceptable trade-off for use as a counter metric.
+ * Interface for counter implementations. Concurrent read and modification of
+ * a counter can yield inconsitent results; this is an acceptable trade-off for
+ * use as a counter metric.
  */
 class CounterImpl {
 public:
+    virtual ~CounterImpl() { }
     void dec() { update(-1); }
     void inc() { update(1); }
+    virtual void update(int64_t delta) = 0;
+    virtual int64_t value() = 0;
+};
+
+/*
+ * A counter backed by an `Accumulator` exposing `add` and `value`; e.g.,
+ * Striped64, which uses a sharded reservior to implement concurrent value
+ * updates w/ reduced contention, or ThreadLocal64 and PerCpu64, which avoid
+ * contention entirely at the cost of more expensive reads.
+ */
+template<typename Accumulator>
+class BasicCounterImpl final : public CounterImpl {
+public:
     void update(int64_t delta) {
         value_.add(delta);
     }
     int64_t value() {
         return value_.value();
     }
+    Accumulator& accumulator() {
+        return value_;
+    }
 private:
-    Striped64 value_;
+    Accumulator value_;
 };
 
 } // ccmetrics namespace
@@ -0,0 +1,99 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ccmetrics/cycle_clock.h"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(CCMETRICS_HAVE_TSC) && !defined(_MSC_VER)
+#include <x86intrin.h>
+#endif
+
+namespace ccmetrics {
+
+std::atomic<int> CycleClock::mode_(UNINITIALIZED);
+double CycleClock::micros_per_tick_ = 1E-3;
+
+namespace {
+
+std::once_flag init_once;
+
+#if defined(CCMETRICS_HAVE_TSC)
+bool cpuinfoHasInvariantTsc() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        // Every processor lists the same flags, so the first will do
+        if (line.compare(0, 5, "flags") == 0) {
+            return CycleClock::invariantTsc(line);
+        }
+    }
+    return false;
+}
+
+// @return microseconds per cycle, or zero if the counter misbehaved
+double calibrate() {
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = __rdtsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    auto t1 = std::chrono::steady_clock::now();
+    uint64_t c1 = __rdtsc();
+
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    if (c1 <= c0 || us <= 0) {
+        return 0;
+    }
+    return us / static_cast<double>(c1 - c0);
+}
+#endif
+
+} // unnamed namespace
+
+bool CycleClock::invariantTsc(std::string const& flags) {
+    std::istringstream in(flags);
+    std::string flag;
+    bool constant = false, nonstop = false;
+    while (in >> flag) {
+        constant = constant || flag == "constant_tsc";
+        nonstop = nonstop || flag == "nonstop_tsc";
+    }
+    return constant && nonstop;
+}
+
+void CycleClock::init() {
+    std::call_once(init_once, []() -> void {
+            int mode = STEADY;
+#if defined(CCMETRICS_HAVE_TSC)
+            if (cpuinfoHasInvariantTsc()) {
+                double us_per_cycle = calibrate();
+                if (us_per_cycle > 0) {
+                    micros_per_tick_ = us_per_cycle;
+                    mode = TSC;
+                }
+            }
+#endif
+            mode_.store(mode, std::memory_order_release);
+        });
+}
+
+} // ccmetrics namespace
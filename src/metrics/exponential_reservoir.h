@@ -24,12 +24,12 @@
 #include <atomic>
 #include <chrono>
 #include <cinttypes>
-#include <mutex>
+#include <cstddef>
 
+#include "ccmetrics/reservoir.h"
 #include "ccmetrics/snapshot.h"
 #include "concurrent_skip_list_map.h"
-#include "hazard_pointers.h"
-#include "metrics/cwg1778hack.h"
+#include "metrics/tick_clock.h"
 
 namespace ccmetrics {
 
@@ -39,65 +39,37 @@ namespace ccmetrics {
  * This sampling method makes strong assumptions on a normal distribution of
  * values, which is probably not the right thing _almost all the time_ when
  * measuring request latencies of a system. As an alternative, consider using
- * the HdrReservoir (TODO: not yet implemented), which consumes much more but
- * provides fixed precision for percentil estimates.
+ * the HdrReservoir, which consumes more memory but provides fixed precision
+ * for percentile estimates.
  *
  * [1] http://dimacs.rutgers.edu/~graham/pubs/papers/fwddecay.pdf
  */
-class ExponentialReservoir {
+class ExponentialReservoir final : public Reservoir {
 public:
-    ExponentialReservoir();
-    ~ExponentialReservoir();
+    static const size_t kDefaultSize = 1028;
+    // Weights the sample to roughly the last five minutes
+    static const double kDefaultAlpha;
 
-    void update(int64_t value);
-    Snapshot snapshot();
+    explicit ExponentialReservoir(size_t size = kDefaultSize,
+        double alpha = kDefaultAlpha);
+
+    void update(int64_t value) override;
+    Snapshot snapshot() override;
 private:
-    // Decay factor
-    static const double kAlpha;
     // Number of elements in reservoir
-    static const double kSize;
-
-    struct Data {
-        // Map from priority -> value, for maintaining ordered decaying weights
-        ConcurrentSkipListMap<double, int64_t> map;
-        // Map size
-        std::atomic<size_t> count;
-        // Landmark for calculating weights
-        decltype(std::chrono::steady_clock::now()) landmark;
-
-        explicit Data(decltype(landmark) time) : count(0), landmark(time) { }
-    };
-
-    // XXX this is starting to feel like onerous boilerplate...
-    struct NewHPFunctor {
-        HazardPointers<Data>::pointer_type* operator()(void) const {
-            return smr.hazards.allocate();
-        }
-    };
-    static struct SMR {
-        HazardPointers<Data> hazards;
-        ThreadLocal<typename decltype(hazards)::pointer_type, NewHPFunctor> hp;
-    } smr;
-    static void retireHazard(void *h) {
-        smr.hazards.retire(
-            reinterpret_cast<decltype(smr.hazards)::pointer_type*>(h));
-    }
-
-    std::atomic<Data*> data_;
-
-    // Time point for next rescaling
-    std::atomic<CWG1778Hack> next_scale_;
-
-    // Used to coordinate rescaling & snapshots, neither of which are on
-    // the common/fast path
-    std::mutex rescale_snap_mutex_;
+    const size_t size_;
+    // Decay factor
+    const double alpha_;
 
-    template<typename TimePoint>
-    Data* loadAndRescaleIfNeeded(
-        typename HazardPointers<Data>::pointer_type& bar, TimePoint now);
-    template<typename TimePoint>
-    Data* rescale(typename HazardPointers<Data>::pointer_type&, TimePoint now,
-        CWG1778Hack next);
+    // Map from log priority -> value, for maintaining ordered decaying
+    // weights. Priorities are kept in log space relative to a fixed
+    // landmark, so they grow linearly rather than exponentially with time
+    // and never need rescaling; see update.
+    ConcurrentSkipListMap<double, int64_t> values_;
+    // Number of updates, used to detect when the reservoir is full
+    std::atomic<size_t> count_;
+    // Landmark for calculating weights
+    const TickClock::time_point landmark_;
 };
 
 } // ccmetrics namespace
@@ -0,0 +1,43 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ccmetrics/gauge.h"
+
+#include <utility>
+
+#include "metrics/gauge_impl.h"
+
+namespace ccmetrics {
+
+Gauge::Gauge() : impl_(new GaugeImpl<int64_t>()) { }
+Gauge::Gauge(std::function<int64_t()> callback)
+    : impl_(new GaugeImpl<int64_t>(std::move(callback))) { }
+Gauge::~Gauge() { delete impl_; }
+void Gauge::set(int64_t value) { impl_->set(value); }
+int64_t Gauge::value() { return impl_->value(); }
+
+DoubleGauge::DoubleGauge() : impl_(new GaugeImpl<double>()) { }
+DoubleGauge::DoubleGauge(std::function<double()> callback)
+    : impl_(new GaugeImpl<double>(std::move(callback))) { }
+DoubleGauge::~DoubleGauge() { delete impl_; }
+void DoubleGauge::set(double value) { impl_->set(value); }
+double DoubleGauge::value() { return impl_->value(); }
+
+} // ccmetrics namespace
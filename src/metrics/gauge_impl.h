@@ -0,0 +1,62 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_GAUGE_IMPL_H_
+#define SRC_METRICS_GAUGE_IMPL_H_
+
+#include <atomic>
+#include <functional>
+#include <utility>
+
+namespace ccmetrics {
+
+/*
+ * A gauge value of type `T`, either stored in an atomic or computed by a
+ * callback on read. Only loads and stores are used on the atomic, so this
+ * is lock-free for doubles as well as integers.
+ */
+template<typename T>
+class GaugeImpl {
+public:
+    GaugeImpl() : value_(T()) { }
+    explicit GaugeImpl(std::function<T()> callback)
+        : value_(T()), callback_(std::move(callback)) { }
+
+    void set(T value) {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    T value() {
+        if (callback_) {
+            return callback_();
+        }
+        return value_.load(std::memory_order_relaxed);
+    }
+private:
+    GaugeImpl(GaugeImpl const&) = delete;
+    GaugeImpl& operator=(GaugeImpl const&) = delete;
+
+    std::atomic<T> value_;
+    std::function<T()> callback_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_GAUGE_IMPL_H_
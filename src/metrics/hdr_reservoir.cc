@@ -0,0 +1,132 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/hdr_reservoir.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <intrin.h>
+#endif
+
+namespace ccmetrics {
+
+const int64_t HdrLayout::kDefaultHighest;
+const int HdrLayout::kDefaultSignificantDigits;
+const int64_t HdrReservoir::kDefaultHighest;
+const int HdrReservoir::kDefaultSignificantDigits;
+
+namespace {
+// Index of the highest set bit; `value` must be non-zero
+int highestBit(uint64_t value) {
+#if defined(_WIN32)
+    unsigned long ret;
+    _BitScanReverse64(&ret, value);
+    return static_cast<int>(ret);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+} // unnamed namespace
+
+HdrLayout::HdrLayout(int64_t highest, int significant_digits)
+        : highest_(highest) {
+    if (highest < 2) {
+        throw std::invalid_argument("highest trackable value must be >= 2");
+    }
+    if (significant_digits < 1 || significant_digits > 5) {
+        throw std::invalid_argument("significant digits must be in [1, 5]");
+    }
+
+    // Sub-buckets needed to resolve the largest value within a bucket to the
+    // requested precision, rounded up to a power of two
+    int64_t largest_single_unit = 2 * static_cast<int64_t>(
+        std::pow(10, significant_digits));
+    int sub_bucket_magnitude = highestBit(largest_single_unit - 1) + 1;
+    half_magnitude_ = sub_bucket_magnitude - 1;
+    int64_t sub_bucket_count = int64_t(1) << sub_bucket_magnitude;
+    half_count_ = sub_bucket_count / 2;
+    sub_bucket_mask_ = sub_bucket_count - 1;
+
+    // Power-of-two ranges needed to cover the highest value
+    size_t ranges = 1;
+    int64_t smallest_untrackable = sub_bucket_count;
+    while (smallest_untrackable <= highest) {
+        if (smallest_untrackable > INT64_MAX / 2) {
+            ++ranges;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        ++ranges;
+    }
+
+    size_ = (ranges + 1) * static_cast<size_t>(half_count_);
+}
+
+size_t HdrLayout::indexOf(int64_t value) const {
+    if (value < 0) {
+        value = 0;
+    } else if (value > highest_) {
+        value = highest_;
+    }
+    int bucket = highestBit(static_cast<uint64_t>(value | sub_bucket_mask_))
+        - half_magnitude_;
+    int64_t sub_bucket = value >> bucket;
+    return (static_cast<size_t>(bucket) << half_magnitude_) +
+        static_cast<size_t>(sub_bucket);
+}
+
+int64_t HdrLayout::valueAt(size_t index) const {
+    int bucket = static_cast<int>(index >> half_magnitude_) - 1;
+    int64_t sub_bucket = static_cast<int64_t>(index & (half_count_ - 1)) +
+        half_count_;
+    if (bucket < 0) {
+        sub_bucket -= half_count_;
+        bucket = 0;
+    }
+    int64_t lowest = sub_bucket << bucket;
+    int64_t width = int64_t(1) << bucket;
+    return lowest + (width >> 1);
+}
+
+HdrReservoir::HdrReservoir(int64_t highest, int significant_digits)
+        : layout_(highest, significant_digits),
+          counts_(new std::atomic<int64_t>[layout_.size()]) {
+    for (size_t i = 0; i < layout_.size(); ++i) {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+HdrReservoir::~HdrReservoir() {
+    delete [] counts_;
+}
+
+void HdrReservoir::update(int64_t value) {
+    counts_[layout_.indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+Snapshot HdrReservoir::snapshot() {
+    return layout_.snapshot([this](size_t i) {
+            return counts_[i].load(std::memory_order_relaxed);
+        });
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,141 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_HDR_RESERVOIR_H_
+#define SRC_METRICS_HDR_RESERVOIR_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "ccmetrics/reservoir.h"
+#include "ccmetrics/snapshot.h"
+
+namespace ccmetrics {
+
+/**
+ * The geometry of log-linear buckets in the style of HdrHistogram [1].
+ *
+ * Values in [0, highest] map to buckets whose width is bounded relative to
+ * the values they hold, so that every value is represented to within
+ * `significant_digits` decimal digits of precision. Values outside that
+ * range are clamped to it.
+ *
+ * [1] http://hdrhistogram.org/
+ */
+class HdrLayout {
+public:
+    /** One hour, in microseconds. */
+    static const int64_t kDefaultHighest = 3600LL * 1000 * 1000;
+    static const int kDefaultSignificantDigits = 2;
+
+    /**
+     * @param highest the highest trackable value; at least 2
+     * @param significant_digits decimal digits of precision, in [1, 5]
+     */
+    HdrLayout(int64_t highest, int significant_digits);
+
+    /** @return the number of buckets. */
+    size_t size() const { return size_; }
+
+    /** @return the highest trackable value. */
+    int64_t highest() const { return highest_; }
+
+    /** @return the bucket holding `value`, after clamping. */
+    size_t indexOf(int64_t value) const;
+
+    /** @return the midpoint of the values held by a bucket. */
+    int64_t valueAt(size_t index) const;
+
+    /**
+     * @return a snapshot of the non-empty buckets, where `countAt(i)` is the
+     * count of bucket `i`.
+     */
+    template<typename F>
+    Snapshot snapshot(F countAt) const;
+private:
+    int64_t highest_;
+    // Each power-of-two range is split into 2^(half_magnitude_ + 1)
+    // sub-buckets, the lower half of which overlap the previous range
+    int half_magnitude_;
+    int64_t half_count_;
+    int64_t sub_bucket_mask_;
+    size_t size_;
+};
+
+/**
+ * A reservoir of HdrLayout buckets. Recording is a bucket index computation
+ * and a single atomic increment; there is no allocation, sampling or decay.
+ *
+ * Unlike the ExponentialReservoir, the distribution covers every value
+ * recorded since creation, and memory is fixed by the range and precision:
+ * e.g., about 26KB for the default of 2 digits over an hour in microseconds.
+ */
+class HdrReservoir final : public Reservoir {
+public:
+    static const int64_t kDefaultHighest = HdrLayout::kDefaultHighest;
+    static const int kDefaultSignificantDigits =
+        HdrLayout::kDefaultSignificantDigits;
+
+    /** See HdrLayout for the arguments. */
+    explicit HdrReservoir(int64_t highest = kDefaultHighest,
+        int significant_digits = kDefaultSignificantDigits);
+    ~HdrReservoir();
+
+    void update(int64_t value) override;
+
+    /**
+     * @return a snapshot of the non-empty buckets, each represented by the
+     * midpoint of the values it holds.
+     */
+    Snapshot snapshot() override;
+
+    /** @return the highest trackable value. */
+    int64_t highest() const { return layout_.highest(); }
+
+    /** @return the number of buckets. */
+    size_t buckets() const { return layout_.size(); }
+private:
+    HdrReservoir(HdrReservoir const&) = delete;
+    HdrReservoir& operator=(HdrReservoir const&) = delete;
+
+    const HdrLayout layout_;
+    std::atomic<int64_t> *counts_;
+};
+
+template<typename F>
+Snapshot HdrLayout::snapshot(F countAt) const {
+    std::vector<int64_t> values = Snapshot::buffer();
+    std::vector<int64_t> counts = Snapshot::buffer();
+    for (size_t i = 0; i < size_; ++i) {
+        int64_t count = countAt(i);
+        if (count > 0) {
+            values.push_back(valueAt(i));
+            counts.push_back(count);
+        }
+    }
+    return Snapshot(std::move(values), std::move(counts));
+}
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_HDR_RESERVOIR_H_
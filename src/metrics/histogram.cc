@@ -20,11 +20,17 @@
 
 #include "metrics/histogram.h"
 
+#include "metrics/exponential_reservoir.h"
+
 namespace ccmetrics {
 
+Histogram::Histogram() : reservoir_(new ExponentialReservoir()) { }
+Histogram::Histogram(Reservoir *reservoir) : reservoir_(reservoir) { }
+Histogram::~Histogram() { delete reservoir_; }
+
 void Histogram::update(int64_t value) {
     count_.add(1);
-    reservoir_.update(value);
+    reservoir_->update(value);
 }
 
 int64_t Histogram::count() {
@@ -32,7 +38,7 @@ int64_t Histogram::count() {
 }
 
 Snapshot Histogram::snapshot() {
-    return reservoir_.snapshot();
+    return reservoir_->snapshot();
 }
 
 } // ccmetrics namespace
@@ -21,8 +21,8 @@
 #ifndef SRC_METRICS_HISTOGRAM_H_
 #define SRC_METRICS_HISTOGRAM_H_
 
+#include "ccmetrics/reservoir.h"
 #include "ccmetrics/snapshot.h"
-#include "metrics/exponential_reservoir.h"
 #include "metrics/striped_int64.h"
 
 namespace ccmetrics {
@@ -30,6 +30,13 @@ namespace ccmetrics {
 /** Counts observations of values in discrete bins. */
 class Histogram {
 public:
+    /** A histogram backed by an ExponentialReservoir. */
+    Histogram();
+
+    /** A histogram backed by `reservoir`, which it takes ownership of. */
+    explicit Histogram(Reservoir *reservoir);
+    ~Histogram();
+
     /** Record a value. */
     void update(int64_t value);
 
@@ -38,9 +45,15 @@ public:
 
     /** @return a snapshot over the approximated distribution. */
     Snapshot snapshot();
+
+    /** @return the backing reservoir. */
+    Reservoir* reservoir() { return reservoir_; }
 private:
+    Histogram(Histogram const&) = delete;
+    Histogram& operator=(Histogram const&) = delete;
+
     Striped64 count_;
-    ExponentialReservoir reservoir_;
+    Reservoir *reservoir_;
 };
 
 } // ccmetrics namespace
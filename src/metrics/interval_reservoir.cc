@@ -0,0 +1,117 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/interval_reservoir.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace ccmetrics {
+
+IntervalReservoir::Recorder::~Recorder() {
+    for (auto& phase : counts) {
+        delete [] phase;
+    }
+}
+
+IntervalReservoir::IntervalReservoir(int64_t highest, int significant_digits)
+        : layout_(highest, significant_digits), phase_(0),
+          retired_(layout_.size(), 0),
+          local_(NewRecorder{this}, &IntervalReservoir::retireRecorder) { }
+
+IntervalReservoir::~IntervalReservoir() {
+    // Recorders are released by the destruction of `local_`
+}
+
+IntervalReservoir::AlignedRecorder*
+IntervalReservoir::NewRecorder::operator()(void) const {
+    AlignedRecorder *rec = new AlignedRecorder();
+    rec->data.owner = owner;
+    size_t n = owner->layout_.size();
+    for (auto& phase : rec->data.counts) {
+        phase = new std::atomic<int64_t>[n];
+        for (size_t i = 0; i < n; ++i) {
+            phase[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(owner->mutex_);
+    owner->recorders_.push_back(rec);
+    return rec;
+}
+
+void IntervalReservoir::retireRecorder(void *ptr) {
+    AlignedRecorder *rec = static_cast<AlignedRecorder*>(ptr);
+    IntervalReservoir *owner = rec->data.owner;
+
+    {
+        // The thread is exiting, so no update is in progress; both phases
+        // hold values not yet drained by a snapshot
+        std::lock_guard<std::mutex> lock(owner->mutex_);
+        for (auto phase : rec->data.counts) {
+            for (size_t i = 0; i < owner->layout_.size(); ++i) {
+                owner->retired_[i] += phase[i].load(std::memory_order_relaxed);
+            }
+        }
+        auto it = std::find(owner->recorders_.begin(), owner->recorders_.end(),
+            rec);
+        assert(it != owner->recorders_.end());
+        // Swap-and-pop; recorder order is immaterial
+        std::swap(*it, owner->recorders_.back());
+        owner->recorders_.pop_back();
+    }
+
+    delete rec;
+}
+
+Snapshot IntervalReservoir::snapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int inactive = phase_.load(std::memory_order_relaxed);
+    phase_.store(1 - inactive, std::memory_order_seq_cst);
+
+    // Wait out updates that may have read the old phase
+    for (AlignedRecorder *rec : recorders_) {
+        uint64_t seq = rec->data.begin.load(std::memory_order_seq_cst);
+        while (rec->data.end.load(std::memory_order_acquire) < seq) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Drain the inactive phase. Its arrays are ours until the next flip,
+    // which publishes the zeroed counts to the writers.
+    std::vector<int64_t> counts = Snapshot::buffer();
+    counts.assign(layout_.size(), 0);
+    std::swap(counts, retired_);
+    for (AlignedRecorder *rec : recorders_) {
+        std::atomic<int64_t> *phase = rec->data.counts[inactive];
+        for (size_t i = 0; i < layout_.size(); ++i) {
+            counts[i] += phase[i].load(std::memory_order_relaxed);
+            phase[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Snapshot ret = layout_.snapshot([&counts](size_t i) { return counts[i]; });
+    Snapshot::recycle(std::move(counts));
+    return ret;
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,124 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_INTERVAL_RESERVOIR_H_
+#define SRC_METRICS_INTERVAL_RESERVOIR_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <mutex>
+#include <vector>
+
+#include "cache_aligned.h"
+#include "ccmetrics/reservoir.h"
+#include "ccmetrics/snapshot.h"
+#include "metrics/hdr_reservoir.h"
+#include "thread_local.h"
+
+namespace ccmetrics {
+
+/**
+ * A reservoir of exact per-interval distributions, recorded into HdrLayout
+ * buckets held by each updating thread.
+ *
+ * Each thread has a pair of count arrays, one per phase. Updates write only
+ * the calling thread's active array and its own phase markers, so there are
+ * no read-modify-write instructions on, or writes to, shared cache lines.
+ * Taking a snapshot flips the phase, waits for any update still writing to
+ * the old phase (in the manner of HdrHistogram's WriterReaderPhaser), then
+ * drains the now-inactive arrays.
+ *
+ * Snapshots are destructive: each covers the values recorded since the
+ * previous snapshot. As with ThreadLocal64, the first update from a thread
+ * takes a lock, and memory is two HdrLayouts of counts per thread.
+ */
+class IntervalReservoir final : public Reservoir {
+public:
+    /** See HdrLayout for the arguments. */
+    explicit IntervalReservoir(
+        int64_t highest = HdrLayout::kDefaultHighest,
+        int significant_digits = HdrLayout::kDefaultSignificantDigits);
+    ~IntervalReservoir();
+
+    void update(int64_t value) override;
+
+    /** @return the distribution recorded since the last snapshot. */
+    Snapshot snapshot() override;
+private:
+    IntervalReservoir(IntervalReservoir const&) = delete;
+    IntervalReservoir& operator=(IntervalReservoir const&) = delete;
+
+    struct Recorder {
+        Recorder() : begin(0), end(0), counts{nullptr, nullptr},
+            owner(nullptr) { }
+        ~Recorder();
+
+        // Only ever written by the owning thread. An update bumps `begin`
+        // before reading the phase and sets `end` to match when done.
+        std::atomic<uint64_t> begin;
+        std::atomic<uint64_t> end;
+        std::atomic<int64_t> *counts[2];
+        IntervalReservoir *owner;
+    };
+    typedef CacheAligned<Recorder> AlignedRecorder;
+
+    struct NewRecorder {
+        IntervalReservoir *owner;
+        AlignedRecorder* operator()(void) const;
+    };
+
+    // Thread exit (or our destruction) hook; folds counts into `retired_`
+    static void retireRecorder(void *recorder);
+
+    const HdrLayout layout_;
+
+    // The phase that updates write to
+    std::atomic<int> phase_;
+
+    // Guards `recorders_` and `retired_`, and serializes snapshots
+    std::mutex mutex_;
+    std::vector<AlignedRecorder*> recorders_;
+    std::vector<int64_t> retired_;
+
+    // NB must be declared last: destroying it retires all live recorders
+    ThreadLocal<AlignedRecorder, NewRecorder> local_;
+};
+
+inline void IntervalReservoir::update(int64_t value) {
+    size_t idx = layout_.indexOf(value);
+    Recorder& rec = local_->data;
+
+    // Single writer; no need for atomic read-modify-writes. The sequentially
+    // consistent store and load pair with those in `snapshot`: either the
+    // snapshot sees this update in progress, or this update sees the flip.
+    uint64_t seq = rec.begin.load(std::memory_order_relaxed) + 1;
+    rec.begin.store(seq, std::memory_order_seq_cst);
+    int phase = phase_.load(std::memory_order_seq_cst);
+
+    auto& count = rec.counts[phase][idx];
+    count.store(count.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+
+    rec.end.store(seq, std::memory_order_release);
+}
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_INTERVAL_RESERVOIR_H_
@@ -0,0 +1,54 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ccmetrics/max_gauge.h"
+
+#include "metrics/striped_extremum.h"
+
+namespace ccmetrics {
+
+namespace {
+template<typename T>
+int64_t orZero(int64_t value) {
+    return value == T::kIdentity ? 0 : value;
+}
+} // unnamed namespace
+
+MaxGauge::MaxGauge() : impl_(new StripedMax()) { }
+MaxGauge::~MaxGauge() { delete impl_; }
+void MaxGauge::update(int64_t x) { impl_->update(x); }
+int64_t MaxGauge::value() {
+    return orZero<StripedMax>(impl_->value());
+}
+int64_t MaxGauge::getAndReset() {
+    return orZero<StripedMax>(impl_->getAndReset());
+}
+
+MinGauge::MinGauge() : impl_(new StripedMin()) { }
+MinGauge::~MinGauge() { delete impl_; }
+void MinGauge::update(int64_t x) { impl_->update(x); }
+int64_t MinGauge::value() {
+    return orZero<StripedMin>(impl_->value());
+}
+int64_t MinGauge::getAndReset() {
+    return orZero<StripedMin>(impl_->getAndReset());
+}
+
+} // ccmetrics namespace
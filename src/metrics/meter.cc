@@ -24,6 +24,8 @@
 namespace ccmetrics {
 
 Meter::Meter() : impl_(new MeterImpl()) { }
+Meter::Meter(MeterOptions const& options)
+    : impl_(new MeterImpl(options)) { }
 Meter::~Meter() { delete impl_; }
 
 void Meter::mark() {
@@ -46,4 +48,12 @@ double Meter::fifteenMinuteRate() {
     return impl_->fifteenMinuteRate();
 }
 
+double Meter::rate(int window_seconds) {
+    return impl_->rate(window_seconds);
+}
+
+std::vector<int> Meter::rateWindows() const {
+    return impl_->rateWindows();
+}
+
 } // ccmetrics namespace
@@ -22,77 +22,101 @@
 
 #include <atomic>
 #include <cmath>
+#include <stdexcept>
+
+#include "metrics/tick_clock.h"
 
 namespace ccmetrics {
 
-double RateEWMA::rate() {
-    tickIfNecessary();
-    return rate_;
+void RateEWMA::configure(double interval, double window) {
+    alpha_ = 1 - std::exp(-interval / window);
+    interval_ = interval;
 }
 
-void RateEWMA::update(int64_t val) {
-    buffer_.add(val);
-    tickIfNecessary();
-}
+void RateEWMA::tick(int64_t uncounted) {
+    double instant = uncounted / interval_;
 
-void RateEWMA::tickIfNecessary() {
-    auto now = std::chrono::steady_clock::now();
-    auto prev = last_tick_.load();
-    auto delta_us = std::chrono::duration_cast<std::chrono::microseconds>(
-        now - prev.t);
+    if (init_) {
+        double rate = rate_.load();
+        while (!rate_.compare_exchange_weak(
+                rate, rate + alpha_ * (instant - rate))) { }
+    } else {
+        rate_ = instant;
+        init_ = true;
+    }
+}
 
-    if (delta_us.count() < kInterval * 1E6) {
-        return;
+MeterImpl::MeterImpl(MeterOptions const& options)
+    : last_tick_(CWG1778Hack(TickClock::now())),
+      external_(false),
+      interval_(options.tick_seconds),
+      size_(options.rate_windows.size()),
+      windows_(new int[size_]),
+      rates_(new RateEWMA[size_]) {
+    if (options.tick_seconds < 1) {
+        throw std::invalid_argument("tick interval must be positive");
     }
+    for (size_t i = 0; i < size_; ++i) {
+        if (options.rate_windows[i] < 1) {
+            throw std::invalid_argument("rate windows must be positive");
+        }
+        windows_[i] = options.rate_windows[i];
+        rates_[i].configure(options.tick_seconds, options.rate_windows[i]);
+    }
+}
 
-    if (!last_tick_.compare_exchange_strong(prev, CWG1778Hack(now))) {
+void MeterImpl::tickIfNecessary() {
+    if (external_.load(std::memory_order_relaxed)) {
         return;
     }
+    tickAt(TickClock::now());
+}
+
+int64_t MeterImpl::tickAt(TickClock::time_point now) {
+    auto prev = last_tick_.load();
+    int64_t iters = (now - prev.t) / interval_;
 
-    int iters = delta_us.count() / (kInterval * 1E6L);
-    for (int i = 0; i < iters; ++i) {
-        // TODO: this could be done more efficiently (wrt atomic CAS) within
-        // the tick method itself. Consider inlining.
-        tick();
+    if (iters < 1) {
+        return 0;
     }
-}
 
-void RateEWMA::tick() {
-    int64_t uncounted = buffer_.value();
-    buffer_.reset(); // XXX you just lost some events. Do you care?
+    // Advance by whole intervals, so that each tick covers exactly one
+    // interval's events however late it runs
+    if (!last_tick_.compare_exchange_strong(prev,
+            CWG1778Hack(prev.t + iters * interval_))) {
+        return 0;
+    }
 
-    double instant = uncounted / static_cast<double>(kInterval);
+    // The first tick folds in the buffered events; any further ticks just
+    // decay the rates over the intervals that passed without one
+    int64_t ticked = 0;
+    for (int64_t i = 0; i < iters; ++i) {
+        ticked += tick();
+    }
+    return ticked;
+}
 
-    if (init_) {
-        double rate = rate_.load();
-        while (!rate_.compare_exchange_weak(
-                rate, rate + alpha_ * (instant - rate))) { }
-    } else {
-        rate_ = instant;
-        init_ = true;
+int64_t MeterImpl::tick() {
+    // Atomically drain the buffer so that concurrent updates carry over to
+    // the next tick rather than being lost
+    int64_t uncounted = uncounted_.sumThenReset();
+    for (size_t i = 0; i < size_; ++i) {
+        rates_[i].tick(uncounted);
     }
+    return uncounted;
 }
 
-MeterImpl::MeterImpl()
-    : oneMinuteRate_(kOneMinuteAlpha),
-      fiveMinuteRate_(kFiveMinuteAlpha),
-      fifteenMinuteRate_(kFifteenMinuteAlpha) {
+void MeterImpl::setTickedExternally(bool external) {
+    external_.store(external, std::memory_order_relaxed);
 }
 
-const double MeterImpl::kOneMinuteAlpha =
-    1 - std::exp(-RateEWMA::kInterval / 60.0);
-const double MeterImpl::kFiveMinuteAlpha =
-    1 - std::exp(-RateEWMA::kInterval / 60.0 / 5.0);
-const double MeterImpl::kFifteenMinuteAlpha =
-    1 - std::exp(-RateEWMA::kInterval / 60.0 / 15.0);
+int64_t MeterImpl::tickExternally(TickClock::time_point now) {
+    return tickAt(now);
+}
 
 void MeterImpl::mark(int n) {
-    // TODO: moving the "tick if necessary" into the meter yields 1/3 the CAS
-    // instructions required by keeping it encapsulated in the rate class.
-    // Probably worthwhile.
-    oneMinuteRate_.update(n);
-    fiveMinuteRate_.update(n);
-    fifteenMinuteRate_.update(n);
+    uncounted_.add(n);
+    tickIfNecessary();
 }
 
 void MeterImpl::mark() {
@@ -100,15 +124,29 @@ void MeterImpl::mark() {
 }
 
 double MeterImpl::oneMinuteRate() {
-    return oneMinuteRate_.rate();
+    return rate(60);
 }
 
 double MeterImpl::fiveMinuteRate() {
-    return fiveMinuteRate_.rate();
+    return rate(300);
 }
 
 double MeterImpl::fifteenMinuteRate() {
-    return fifteenMinuteRate_.rate();
+    return rate(900);
+}
+
+double MeterImpl::rate(int window_seconds) {
+    tickIfNecessary();
+    for (size_t i = 0; i < size_; ++i) {
+        if (windows_[i] == window_seconds) {
+            return rates_[i].rate();
+        }
+    }
+    return 0.0;
+}
+
+std::vector<int> MeterImpl::rateWindows() const {
+    return std::vector<int>(windows_.get(), windows_.get() + size_);
 }
 
 } // ccmetrics namespace
@@ -21,59 +21,79 @@
 #ifndef SRC_METRICS_METER_H_
 #define SRC_METRICS_METER_H_
 
+#include <atomic>
+#include <chrono>
 #include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <vector>
 
+#include "ccmetrics/meter.h"
 #include "metrics/cwg1778hack.h"
+#include "metrics/tick_clock.h"
 #include "striped_int64.h"
 
 namespace ccmetrics {
 
-namespace test { class RateEWMATest; }
+namespace test { class MeterImplTest; }
 
 /**
  * Exponentially weighted moving average of a rate.
  *
  * This class is an average over a _time window_, not over the sample count.
- * It buffers updates and applys them when ticked. In the case that no tick-
- * invoking method is called for > 1 tick period, it repeatedly invokes the
- * tick method to decay the rate.
+ * It is fed the number of events seen in each tick interval by its owner,
+ * which buffers events and keeps the tick clock; see MeterImpl.
  */
 class RateEWMA {
 public:
-    explicit RateEWMA(double alpha) : alpha_(alpha), rate_(0.0), init_(false),
-        last_tick_(CWG1778Hack(std::chrono::steady_clock::now())) { }
+    /** An average that must be configured before it is ticked. */
+    RateEWMA() : alpha_(0.0), interval_(1.0), rate_(0.0), init_(false) { }
 
-    /** Update the average with a new value. */
-    void update(int64_t val);
+    /**
+     * @param interval the tick interval, in seconds
+     * @param window the averaging window, in seconds
+     */
+    RateEWMA(double interval, double window) : rate_(0.0), init_(false) {
+        configure(interval, window);
+    }
 
-    /** @return the rate. */
-    double rate();
+    /** Sets the tick interval and window, before any ticks. */
+    void configure(double interval, double window);
 
-    static constexpr const int32_t kInterval = 5; // seconds
-private:
-    /** Tick the time forward if necessary. */
-    void tickIfNecessary();
+    /** Fold the `uncounted` events from one tick interval into the rate. */
+    void tick(int64_t uncounted);
 
-    /** Tick the time forward one interval. */
-    void tick();
+    /** @return the rate, as of the last tick. */
+    double rate() const { return rate_; }
+private:
+    RateEWMA(RateEWMA const&) = delete;
+    RateEWMA& operator=(RateEWMA const&) = delete;
 
     double alpha_;
-    // Buffered updates
-    Striped64 buffer_;
+    double interval_;
     std::atomic<double> rate_;
     std::atomic<bool> init_;
-    std::atomic<CWG1778Hack> last_tick_;
-
-    friend class test::RateEWMATest;
 };
 
 /**
- * Meter that tracks exponentially weighted moving average for one, five, and
- * fifteen minute rates. Thus, basicallly UNIX load average.
+ * Meter that tracks exponentially weighted moving averages over a set of
+ * windows; by default one, five, and fifteen minutes. Thus, basicallly UNIX
+ * load average.
+ *
+ * Events are buffered in a single striped counter, and one tick clock feeds
+ * the buffered count to every average, kept in one array. Marking costs one
+ * striped add and one clock read, however many windows there are. In the
+ * case that no tick-invoking method is called for > 1 tick period, it
+ * repeatedly ticks to decay the rates.
+ *
+ * When ticked externally (e.g. by the registry's ticker thread), neither
+ * marking nor reading the rates touches the clock, and marking is a bare
+ * striped add.
  */
 class MeterImpl {
 public:
-    MeterImpl();
+    /** @throws std::invalid_argument for non-positive intervals or windows */
+    explicit MeterImpl(MeterOptions const& options = MeterOptions());
 
     /** Mark that an event occurred. */
     void mark();
@@ -90,15 +110,52 @@ public:
     /** @return fifteen minute rate. */
     double fifteenMinuteRate();
 
-    // visible for testing
-    static const double kOneMinuteAlpha;
-    static const double kFiveMinuteAlpha;
-    static const double kFifteenMinuteAlpha;
+    /** @return the rate over `window_seconds`, or zero if not tracked. */
+    double rate(int window_seconds);
+
+    /** @return the windows of the tracked rates, in seconds. */
+    std::vector<int> rateWindows() const;
+
+    /**
+     * Switches between external ticking, where the owner calls
+     * `tickExternally` with the time, and lazy ticking on access.
+     */
+    void setTickedExternally(bool external);
+
+    /**
+     * Tick the time forward to `now`, if a tick interval has passed.
+     *
+     * @return the number of buffered events folded into the rates
+     */
+    int64_t tickExternally(TickClock::time_point now);
 private:
+    MeterImpl(MeterImpl const&) = delete;
+    MeterImpl& operator=(MeterImpl const&) = delete;
+
+    /** Tick the time forward if necessary. */
+    void tickIfNecessary();
+
+    /** Tick the time forward to `now`, if necessary. */
+    int64_t tickAt(TickClock::time_point now);
+
+    /**
+     * Tick the time forward one interval.
+     *
+     * @return the number of buffered events folded into the rates
+     */
+    int64_t tick();
+
+    // Buffered updates
+    Striped64 uncounted_;
+    std::atomic<CWG1778Hack> last_tick_;
+    std::atomic<bool> external_;
+
+    const std::chrono::seconds interval_;
+    const size_t size_;
+    std::unique_ptr<int[]> windows_;
+    std::unique_ptr<RateEWMA[]> rates_;
 
-    RateEWMA oneMinuteRate_;
-    RateEWMA fiveMinuteRate_;
-    RateEWMA fifteenMinuteRate_;
+    friend class test::MeterImplTest;
 };
 
 } // ccmetrics namespace
@@ -0,0 +1,71 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/per_cpu_int64.h"
+
+#if defined(CCMETRICS_HAVE_RSEQ)
+#include <unistd.h>
+#endif
+
+namespace ccmetrics {
+
+namespace {
+size_t cpuCount() {
+#if defined(CCMETRICS_HAVE_RSEQ)
+    // Configured (not online) CPUs, which bounds the ids the kernel reports
+    long n = sysconf(_SC_NPROCESSORS_CONF);
+    if (n > 0) {
+        return static_cast<size_t>(n);
+    }
+#endif
+    return 1;
+}
+} // unnamed namespace
+
+PerCpu64::PerCpu64() : size_(cpuCount()),
+        cells_(new CacheAligned<std::atomic<int64_t>>[size_]) {
+    for (size_t i = 0; i < size_; ++i) {
+        cells_[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+PerCpu64::~PerCpu64() {
+    delete [] cells_;
+}
+
+bool PerCpu64::available() {
+#if defined(CCMETRICS_HAVE_RSEQ)
+    // Zero if rseq registration was disabled (e.g., via glibc tunables) or
+    // is not supported by the kernel
+    return __rseq_size > 0 && currentCpu() < cpuCount();
+#else
+    return false;
+#endif
+}
+
+int64_t PerCpu64::value() {
+    int64_t ret = 0;
+    for (size_t i = 0; i < size_; ++i) {
+        ret += cells_[i].data.load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+} // ccmetrics namespace
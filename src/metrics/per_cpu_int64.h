@@ -0,0 +1,105 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_PER_CPU_INT64_H_
+#define SRC_METRICS_PER_CPU_INT64_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+
+#include "cache_aligned.h"
+
+#if defined(__linux__) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 35))
+// glibc registers a restartable sequences area for every thread and exports
+// its location; the kernel keeps the current CPU id there up to date.
+#define CCMETRICS_HAVE_RSEQ 1
+#include <sched.h>
+#include <sys/rseq.h>
+#endif
+
+namespace ccmetrics {
+
+/**
+ * A 64-bit signed value with one cache-aligned cell per CPU.
+ *
+ * Updates are applied to the cell of the CPU the calling thread is running
+ * on, as published by the kernel in the thread's restartable sequences
+ * (rseq) area. Threads on different CPUs never share a cache line and never
+ * retry, and memory is bounded by the number of CPUs rather than threads.
+ *
+ * A thread may migrate between reading its CPU id and updating the cell, so
+ * the update is an atomic add rather than a plain store; this is rare enough
+ * that the cell line stays effectively CPU-local. As with Striped64, reads
+ * concurrent with updates may observe only some of the updated values.
+ *
+ * Only available on Linux with glibc 2.35+ and rseq registration enabled;
+ * see `available`.
+ */
+class PerCpu64 {
+public:
+    PerCpu64();
+    ~PerCpu64();
+
+    /** @return whether the current CPU can be determined cheaply. */
+    static bool available();
+
+    /** @return the current value, with consistency caveats as above. */
+    int64_t value();
+
+    /** += value. */
+    void add(int64_t value);
+private:
+    PerCpu64(PerCpu64 const&) = delete;
+    PerCpu64& operator=(PerCpu64 const&) = delete;
+
+    /** @return the CPU the calling thread is running on. */
+    static uint32_t currentCpu();
+
+    size_t size_;
+    CacheAligned<std::atomic<int64_t>> *cells_;
+};
+
+inline uint32_t PerCpu64::currentCpu() {
+#if defined(CCMETRICS_HAVE_RSEQ)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+    const volatile struct rseq *area = reinterpret_cast<struct rseq*>(
+        reinterpret_cast<char*>(__builtin_thread_pointer()) + __rseq_offset);
+    return area->cpu_id;
+#else
+    // glibc serves this from the rseq area as well, at the cost of a call
+    return static_cast<uint32_t>(sched_getcpu());
+#endif
+#else
+    return 0;
+#endif
+}
+
+inline void PerCpu64::add(int64_t value) {
+    uint32_t cpu = currentCpu();
+    // Unregistered threads report a negative id; fall back to any cell
+    auto& cell = cells_[cpu < size_ ? cpu : 0].data;
+    cell.fetch_add(value, std::memory_order_relaxed);
+}
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_PER_CPU_INT64_H_
@@ -0,0 +1,262 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ccmetrics/quantile_sketch.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace ccmetrics {
+
+namespace {
+const uint8_t kEncodingVersion = 1;
+
+void putVarint(std::string *out, uint64_t value) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<char>(value));
+}
+
+uint64_t getVarint(std::string const& in, size_t *pos) {
+    uint64_t ret = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= in.size()) {
+            throw std::invalid_argument("truncated sketch encoding");
+        }
+        uint8_t byte = static_cast<uint8_t>(in[(*pos)++]);
+        ret |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return ret;
+        }
+    }
+    throw std::invalid_argument("malformed varint in sketch encoding");
+}
+
+// Buckets are encoded as the index of the first non-empty bucket, then the
+// counts through the last non-empty bucket
+void putBuckets(std::string *out, std::vector<int64_t> const& counts,
+        size_t offset) {
+    size_t first = 0;
+    while (first < counts.size() && counts[first] == 0) {
+        ++first;
+    }
+    size_t last = counts.size();
+    while (last > first && counts[last - 1] == 0) {
+        --last;
+    }
+    putVarint(out, first == last ? 0 : offset + first);
+    putVarint(out, last - first);
+    for (size_t i = first; i < last; ++i) {
+        putVarint(out, static_cast<uint64_t>(counts[i]));
+    }
+}
+
+// Reads buckets into `counts`, returning the index of the first
+uint64_t getBuckets(std::string const& in, size_t *pos, size_t limit,
+        std::vector<int64_t> *counts) {
+    uint64_t first = getVarint(in, pos);
+    uint64_t n = getVarint(in, pos);
+    if (first > limit || n > limit - first) {
+        throw std::invalid_argument("sketch bucket out of range");
+    }
+    // Every count takes at least a byte, so a short payload cannot claim
+    // more buckets than it has bytes left. Leading empty buckets are not
+    // stored at all.
+    if (n > in.size() - *pos) {
+        throw std::invalid_argument("truncated sketch encoding");
+    }
+    counts->assign(static_cast<size_t>(n), 0);
+    for (size_t i = 0; i < counts->size(); ++i) {
+        (*counts)[i] = static_cast<int64_t>(getVarint(in, pos));
+    }
+    return first;
+}
+
+// Grows `counts`, which starts at bucket `*offset`, to cover bucket `index`
+// @return the position of `index` in `counts`
+size_t cover(std::vector<int64_t> *counts, size_t *offset, size_t index) {
+    if (counts->empty()) {
+        *offset = index;
+    } else if (index < *offset) {
+        counts->insert(counts->begin(), *offset - index, 0);
+        *offset = index;
+    }
+    size_t i = index - *offset;
+    if (counts->size() <= i) {
+        counts->resize(i + 1, 0);
+    }
+    return i;
+}
+} // unnamed namespace
+
+// Finer accuracies need tens of millions of buckets to span int64_t, and
+// below about 1e-16 gamma rounds to one and indexing breaks down entirely
+const double QuantileSketch::kMinAccuracy = 1E-6;
+
+QuantileSketch::QuantileSketch(double accuracy) : accuracy_(accuracy),
+        zero_count_(0) {
+    if (!(accuracy >= kMinAccuracy && accuracy < 1.0)) {
+        throw std::invalid_argument("accuracy must be in [1e-6, 1)");
+    }
+    gamma_ = (1.0 + accuracy) / (1.0 - accuracy);
+    multiplier_ = 1.0 / std::log(gamma_);
+    if (!(gamma_ > 1.0) || !std::isfinite(multiplier_)) {
+        throw std::invalid_argument("accuracy is too fine");
+    }
+}
+
+size_t QuantileSketch::indexOf(uint64_t magnitude) const {
+    return static_cast<size_t>(std::ceil(
+        std::log(static_cast<double>(magnitude)) * multiplier_));
+}
+
+int64_t QuantileSketch::valueAt(size_t index) const {
+    // The point within the relative accuracy of both bucket bounds
+    double value = 2.0 * std::pow(gamma_, static_cast<double>(index)) /
+        (gamma_ + 1.0);
+    if (value >= 9.2e18) {
+        return INT64_MAX;
+    }
+    return std::max<int64_t>(1, std::llround(value));
+}
+
+void QuantileSketch::update(int64_t value, int64_t count) {
+    if (value == 0) {
+        zero_count_ += count;
+        return;
+    }
+    Buckets *buckets = value > 0 ? &positive_ : &negative_;
+    // Negating through the unsigned type is safe for INT64_MIN
+    uint64_t magnitude = value > 0 ? static_cast<uint64_t>(value)
+        : 0 - static_cast<uint64_t>(value);
+    size_t i = cover(&buckets->counts, &buckets->offset, indexOf(magnitude));
+    buckets->counts[i] += count;
+}
+
+void QuantileSketch::merge(QuantileSketch const& other) {
+    if (other.accuracy_ != accuracy_) {
+        throw std::invalid_argument("cannot merge sketches with different "
+            "accuracies");
+    }
+    zero_count_ += other.zero_count_;
+    mergeBuckets(&positive_, other.positive_);
+    mergeBuckets(&negative_, other.negative_);
+}
+
+void QuantileSketch::mergeBuckets(Buckets *to, Buckets const& from) {
+    if (from.counts.empty()) {
+        return;
+    }
+    // Cover both ends first, so that the loop below never moves the counts
+    cover(&to->counts, &to->offset, from.offset);
+    size_t base = cover(&to->counts, &to->offset,
+        from.offset + from.counts.size() - 1) - (from.counts.size() - 1);
+    for (size_t i = 0; i < from.counts.size(); ++i) {
+        to->counts[base + i] += from.counts[i];
+    }
+}
+
+int64_t QuantileSketch::count() const {
+    int64_t ret = zero_count_;
+    for (int64_t count : positive_.counts) {
+        ret += count;
+    }
+    for (int64_t count : negative_.counts) {
+        ret += count;
+    }
+    return ret;
+}
+
+Snapshot QuantileSketch::snapshot() const {
+    std::vector<int64_t> values = Snapshot::buffer();
+    std::vector<int64_t> counts = Snapshot::buffer();
+    // Ascending: negatives by decreasing magnitude, zero, then positives
+    for (size_t i = negative_.counts.size(); i > 0; --i) {
+        if (negative_.counts[i - 1] > 0) {
+            values.push_back(-valueAt(negative_.offset + i - 1));
+            counts.push_back(negative_.counts[i - 1]);
+        }
+    }
+    if (zero_count_ > 0) {
+        values.push_back(0);
+        counts.push_back(zero_count_);
+    }
+    for (size_t i = 0; i < positive_.counts.size(); ++i) {
+        if (positive_.counts[i] > 0) {
+            values.push_back(valueAt(positive_.offset + i));
+            counts.push_back(positive_.counts[i]);
+        }
+    }
+    return Snapshot(std::move(values), std::move(counts));
+}
+
+std::string QuantileSketch::encode() const {
+    std::string ret;
+    ret.push_back(static_cast<char>(kEncodingVersion));
+
+    uint64_t bits;
+    memcpy(&bits, &accuracy_, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        ret.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+
+    putVarint(&ret, static_cast<uint64_t>(zero_count_));
+    putBuckets(&ret, positive_.counts, positive_.offset);
+    putBuckets(&ret, negative_.counts, negative_.offset);
+    return ret;
+}
+
+QuantileSketch QuantileSketch::decode(std::string const& bytes) {
+    if (bytes.size() < 9 ||
+            static_cast<uint8_t>(bytes[0]) != kEncodingVersion) {
+        throw std::invalid_argument("unknown sketch encoding");
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        bits |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[1 + i]))
+            << (8 * i);
+    }
+    double accuracy;
+    memcpy(&accuracy, &bits, sizeof(accuracy));
+
+    QuantileSketch ret(accuracy);
+    // No int64_t magnitude has a bucket beyond this one
+    size_t limit = ret.indexOf(UINT64_MAX) + 1;
+
+    size_t pos = 9;
+    ret.zero_count_ = static_cast<int64_t>(getVarint(bytes, &pos));
+    ret.positive_.offset = static_cast<size_t>(
+        getBuckets(bytes, &pos, limit, &ret.positive_.counts));
+    ret.negative_.offset = static_cast<size_t>(
+        getBuckets(bytes, &pos, limit, &ret.negative_.counts));
+    if (pos != bytes.size()) {
+        throw std::invalid_argument("trailing bytes in sketch encoding");
+    }
+    return ret;
+}
+
+} // ccmetrics namespace
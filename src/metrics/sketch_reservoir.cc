@@ -0,0 +1,105 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/sketch_reservoir.h"
+
+namespace ccmetrics {
+
+namespace {
+std::atomic<int64_t>* newBuckets(size_t n) {
+    std::atomic<int64_t> *ret = new std::atomic<int64_t>[n];
+    for (size_t i = 0; i < n; ++i) {
+        ret[i].store(0, std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+} // unnamed namespace
+
+// Copies just the span of non-empty buckets
+void SketchReservoir::copyBuckets(std::atomic<int64_t> *from, size_t n,
+        QuantileSketch::Buckets *to) {
+    to->counts.clear();
+    for (size_t i = 0; i < n; ++i) {
+        int64_t count = from[i].load(std::memory_order_relaxed);
+        if (count == 0 && to->counts.empty()) {
+            continue;
+        }
+        if (to->counts.empty()) {
+            to->offset = i;
+        }
+        to->counts.push_back(count);
+    }
+    while (!to->counts.empty() && to->counts.back() == 0) {
+        to->counts.pop_back();
+    }
+}
+
+SketchReservoir::SketchReservoir(double accuracy) : mapping_(accuracy),
+        size_(mapping_.indexOf(UINT64_MAX) + 1), zero_count_(0),
+        positive_(newBuckets(size_)), negative_(nullptr) { }
+
+SketchReservoir::~SketchReservoir() {
+    delete [] positive_;
+    delete [] negative_.load();
+}
+
+std::atomic<int64_t>* SketchReservoir::negative() {
+    std::atomic<int64_t> *ret = negative_.load(std::memory_order_acquire);
+    if (ret) {
+        return ret;
+    }
+    std::atomic<int64_t> *created = newBuckets(size_);
+    if (negative_.compare_exchange_strong(ret, created)) {
+        return created;
+    }
+    // Lost the race to create the buckets; use the winner's
+    delete [] created;
+    return ret;
+}
+
+void SketchReservoir::update(int64_t value) {
+    if (value > 0) {
+        positive_[mapping_.indexOf(static_cast<uint64_t>(value))].fetch_add(1,
+            std::memory_order_relaxed);
+    } else if (value < 0) {
+        negative()[mapping_.indexOf(0 - static_cast<uint64_t>(value))]
+            .fetch_add(1, std::memory_order_relaxed);
+    } else {
+        zero_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QuantileSketch SketchReservoir::sketch() {
+    QuantileSketch ret(mapping_.accuracy());
+    ret.zero_count_ = zero_count_.load(std::memory_order_relaxed);
+    copyBuckets(positive_, size_, &ret.positive_);
+    std::atomic<int64_t> *neg = negative_.load(std::memory_order_acquire);
+    if (neg) {
+        copyBuckets(neg, size_, &ret.negative_);
+    }
+    return ret;
+}
+
+Snapshot SketchReservoir::snapshot() {
+    return sketch().snapshot();
+}
+
+} // ccmetrics namespace
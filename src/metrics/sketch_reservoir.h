@@ -0,0 +1,74 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_SKETCH_RESERVOIR_H_
+#define SRC_METRICS_SKETCH_RESERVOIR_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+
+#include "ccmetrics/quantile_sketch.h"
+#include "ccmetrics/reservoir.h"
+#include "ccmetrics/snapshot.h"
+
+namespace ccmetrics {
+
+/**
+ * A reservoir that counts every value in a QuantileSketch's buckets.
+ *
+ * Buckets are preallocated atomics over the whole int64_t range, so
+ * recording is a logarithm and an atomic increment, with no allocation. The
+ * array grows inversely with the accuracy: about 17KB for positive values at
+ * the default 1%, 170KB at 0.1%, and 177MB at the finest supported accuracy
+ * (QuantileSketch::kMinAccuracy), so fine accuracies suit few timers. Negative values,
+ * which durations should not produce, are counted in a second array that is
+ * allocated on first use.
+ */
+class SketchReservoir final : public Reservoir {
+public:
+    explicit SketchReservoir(double accuracy = 0.01);
+    ~SketchReservoir();
+
+    void update(int64_t value) override;
+    Snapshot snapshot() override;
+
+    /** @return a copy of the sketch of the recorded values. */
+    QuantileSketch sketch();
+private:
+    SketchReservoir(SketchReservoir const&) = delete;
+    SketchReservoir& operator=(SketchReservoir const&) = delete;
+
+    std::atomic<int64_t>* negative();
+
+    static void copyBuckets(std::atomic<int64_t> *from, size_t n,
+        QuantileSketch::Buckets *to);
+
+    // Used for its bucket mapping only
+    const QuantileSketch mapping_;
+    const size_t size_;
+    std::atomic<int64_t> zero_count_;
+    std::atomic<int64_t> *positive_;
+    std::atomic<std::atomic<int64_t>*> negative_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_SKETCH_RESERVOIR_H_
@@ -0,0 +1,58 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/sliding_count_reservoir.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ccmetrics {
+
+const size_t SlidingCountReservoir::kDefaultSize;
+
+SlidingCountReservoir::SlidingCountReservoir(size_t size)
+        : size_(size), count_(0) {
+    if (size == 0) {
+        throw std::invalid_argument("reservoir size must be positive");
+    }
+    values_ = new std::atomic<int64_t>[size_];
+    for (size_t i = 0; i < size_; ++i) {
+        values_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+SlidingCountReservoir::~SlidingCountReservoir() {
+    delete [] values_;
+}
+
+Snapshot SlidingCountReservoir::snapshot() {
+    size_t n = static_cast<size_t>(std::min<uint64_t>(
+        count_.load(std::memory_order_relaxed), size_));
+    std::vector<int64_t> values = Snapshot::buffer();
+    values.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = values_[i].load(std::memory_order_relaxed);
+    }
+    return Snapshot(std::move(values), /*sorted=*/ false);
+}
+
+} // ccmetrics namespace
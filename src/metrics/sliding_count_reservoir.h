@@ -0,0 +1,65 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_SLIDING_COUNT_RESERVOIR_H_
+#define SRC_METRICS_SLIDING_COUNT_RESERVOIR_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+
+#include "ccmetrics/reservoir.h"
+#include "ccmetrics/snapshot.h"
+
+namespace ccmetrics {
+
+/**
+ * A reservoir of the last `size` recorded values, kept in a ring buffer.
+ *
+ * An update is a single atomic increment of the write index and an atomic
+ * store into the ring; there is no allocation, randomness or decay.
+ * Snapshots concurrent with updates may observe a slot that has been claimed
+ * but not yet written, i.e. one of the values just before the window.
+ */
+class SlidingCountReservoir final : public Reservoir {
+public:
+    static const size_t kDefaultSize = 1028;
+
+    explicit SlidingCountReservoir(size_t size = kDefaultSize);
+    ~SlidingCountReservoir();
+
+    void update(int64_t value) override {
+        uint64_t n = count_.fetch_add(1, std::memory_order_relaxed);
+        values_[n % size_].store(value, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() override;
+private:
+    SlidingCountReservoir(SlidingCountReservoir const&) = delete;
+    SlidingCountReservoir& operator=(SlidingCountReservoir const&) = delete;
+
+    const size_t size_;
+    std::atomic<uint64_t> count_;
+    std::atomic<int64_t> *values_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_SLIDING_COUNT_RESERVOIR_H_
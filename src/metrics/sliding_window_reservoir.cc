@@ -0,0 +1,106 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/sliding_window_reservoir.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace ccmetrics {
+
+const int SlidingWindowReservoir::kDefaultWindow;
+const int64_t SlidingWindowReservoir::kRecycling;
+
+SlidingWindowReservoir::SlidingWindowReservoir(int window, int64_t highest,
+        int significant_digits)
+        : layout_(highest, significant_digits),
+          origin_(TickClock::now()),
+          size_(window > 0 ? static_cast<size_t>(window) : 0) {
+    if (window < 1) {
+        throw std::invalid_argument("window must be at least one second");
+    }
+    slots_ = new Slot[size_];
+    for (size_t i = 0; i < size_; ++i) {
+        // Slot i first holds second i, so every slot starts out live and
+        // empty rather than needing a recycle
+        slots_[i].epoch.store(static_cast<int64_t>(i),
+            std::memory_order_relaxed);
+        slots_[i].counts = new std::atomic<int64_t>[layout_.size()];
+        for (size_t j = 0; j < layout_.size(); ++j) {
+            slots_[i].counts[j].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+SlidingWindowReservoir::~SlidingWindowReservoir() {
+    for (size_t i = 0; i < size_; ++i) {
+        delete [] slots_[i].counts;
+    }
+    delete [] slots_;
+}
+
+void SlidingWindowReservoir::recycle(Slot& slot, int64_t epoch,
+        int64_t second) {
+    if (!slot.epoch.compare_exchange_strong(epoch, kRecycling)) {
+        // Somebody else is recycling (or has recycled) the slot
+        return;
+    }
+    for (size_t i = 0; i < layout_.size(); ++i) {
+        slot.counts[i].store(0, std::memory_order_relaxed);
+    }
+    slot.epoch.store(second, std::memory_order_release);
+}
+
+void SlidingWindowReservoir::updateAt(int64_t value, int64_t second) {
+    Slot& slot = slots_[second % size_];
+    int64_t epoch = slot.epoch.load(std::memory_order_acquire);
+    if (epoch != second) {
+        if (epoch > second) {
+            // The clock read is stale, and its slot has moved on
+            return;
+        }
+        if (epoch != kRecycling) {
+            recycle(slot, epoch, second);
+        }
+    }
+    slot.counts[layout_.indexOf(value)].fetch_add(1,
+        std::memory_order_relaxed);
+}
+
+Snapshot SlidingWindowReservoir::snapshotAt(int64_t second) {
+    // Slots are live if they hold one of the last `size_` seconds
+    const int64_t oldest = second - static_cast<int64_t>(size_);
+    std::vector<int64_t> counts = Snapshot::buffer();
+    counts.assign(layout_.size(), 0);
+    for (size_t i = 0; i < size_; ++i) {
+        int64_t epoch = slots_[i].epoch.load(std::memory_order_acquire);
+        if (epoch <= oldest || epoch > second) {
+            continue;
+        }
+        for (size_t j = 0; j < layout_.size(); ++j) {
+            counts[j] += slots_[i].counts[j].load(std::memory_order_relaxed);
+        }
+    }
+    Snapshot ret = layout_.snapshot([&counts](size_t i) { return counts[i]; });
+    Snapshot::recycle(std::move(counts));
+    return ret;
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,107 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_SLIDING_WINDOW_RESERVOIR_H_
+#define SRC_METRICS_SLIDING_WINDOW_RESERVOIR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+
+#include "ccmetrics/reservoir.h"
+#include "ccmetrics/snapshot.h"
+#include "metrics/hdr_reservoir.h"
+#include "metrics/tick_clock.h"
+
+namespace ccmetrics {
+
+/**
+ * A reservoir of the values recorded in the last `window` seconds, kept as a
+ * ring of per-second HdrLayout sub-histograms.
+ *
+ * Recording is O(1) and lock-free: an atomic increment in the sub-histogram
+ * for the current second. The first update to land in a new second claims
+ * the slot with a CAS and recycles it by zeroing its counts; updates racing
+ * with the recycling of a slot may be dropped. Snapshots merge the slots
+ * whose second is within the window, so values age out exactly, rather
+ * than decaying.
+ *
+ * Memory is `window` HdrLayouts of counts, so lower precision may be
+ * preferable for long windows.
+ */
+class SlidingWindowReservoir final : public Reservoir {
+public:
+    static const int kDefaultWindow = 60;
+
+    /**
+     * @param window the window length in seconds; at least 1
+     * @param highest see HdrLayout
+     * @param significant_digits see HdrLayout
+     */
+    explicit SlidingWindowReservoir(int window = kDefaultWindow,
+        int64_t highest = HdrLayout::kDefaultHighest,
+        int significant_digits = HdrLayout::kDefaultSignificantDigits);
+    ~SlidingWindowReservoir();
+
+    void update(int64_t value) override {
+        updateAt(value, now());
+    }
+
+    /** @return the distribution of values recorded within the window. */
+    Snapshot snapshot() override {
+        return snapshotAt(now());
+    }
+
+    /** @return the window length in seconds. */
+    int window() const { return static_cast<int>(size_); }
+
+    // Visible for testing; `second` is relative to construction
+    void updateAt(int64_t value, int64_t second);
+    Snapshot snapshotAt(int64_t second);
+private:
+    SlidingWindowReservoir(SlidingWindowReservoir const&) = delete;
+    SlidingWindowReservoir& operator=(SlidingWindowReservoir const&) = delete;
+
+    // The epoch of a slot being recycled
+    static const int64_t kRecycling = -1;
+
+    struct Slot {
+        // The second whose values the slot holds
+        std::atomic<int64_t> epoch;
+        std::atomic<int64_t> *counts;
+    };
+
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            TickClock::now() - origin_).count();
+    }
+
+    void recycle(Slot& slot, int64_t epoch, int64_t second);
+
+    const HdrLayout layout_;
+    const TickClock::time_point origin_;
+    const size_t size_;
+    Slot *slots_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_SLIDING_WINDOW_RESERVOIR_H_
@@ -0,0 +1,80 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_STRIPED_DOUBLE_H_
+#define SRC_METRICS_STRIPED_DOUBLE_H_
+
+#include <string.h>
+
+#include "metrics/striped_int64.h"
+
+namespace ccmetrics {
+
+/**
+ * A double-precision value that stripes updates like Striped64, with which
+ * it shares its stripe expansion and hashing. Cells hold the bit patterns
+ * of doubles and are updated with a CAS of the sum.
+ *
+ * Consistency caveats are as for Striped64. In addition, floating-point
+ * addition is not associative, so the value may differ in its low-order
+ * bits depending on how updates were distributed across the stripes.
+ */
+class StripedDouble : public Striped64_Base {
+public:
+    StripedDouble() : Striped64_Base(toBits(0.0)) { }
+    // Basically just for testing
+    explicit StripedDouble(size_t k) : Striped64_Base(toBits(0.0), k) { }
+
+    /** @return the current value, with consistency caveats as above. */
+    double value();
+
+    /** Reset to zero. */
+    void reset();
+
+    /** Reset to zero, returning the value drained; see Striped64. */
+    double sumThenReset();
+
+    /** += value. */
+    void add(double value) {
+        accumulate<Add>(toBits(value));
+    }
+private:
+    static int64_t toBits(double value) {
+        int64_t ret;
+        memcpy(&ret, &value, sizeof(ret));
+        return ret;
+    }
+
+    static double fromBits(int64_t bits) {
+        double ret;
+        memcpy(&ret, &bits, sizeof(ret));
+        return ret;
+    }
+
+    struct Add {
+        static int64_t apply(int64_t cur, int64_t x) {
+            return toBits(fromBits(cur) + fromBits(x));
+        }
+    };
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_STRIPED_DOUBLE_H_
@@ -0,0 +1,76 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/striped_extremum.h"
+
+#include <algorithm>
+
+namespace ccmetrics {
+
+const int64_t StripedMax::kIdentity;
+const int64_t StripedMin::kIdentity;
+
+int64_t StripedMax::value() {
+    int64_t ret = kIdentity;
+    forEachCell([&ret](std::atomic<int64_t>& cell) {
+            ret = std::max(ret, cell.load(std::memory_order_relaxed));
+        });
+    return ret;
+}
+
+void StripedMax::reset() {
+    forEachCell([](std::atomic<int64_t>& cell) {
+            cell.store(kIdentity, std::memory_order_release);
+        });
+}
+
+int64_t StripedMax::getAndReset() {
+    int64_t ret = kIdentity;
+    forEachCell([&ret](std::atomic<int64_t>& cell) {
+            ret = std::max(ret, cell.exchange(kIdentity,
+                std::memory_order_acq_rel));
+        });
+    return ret;
+}
+
+int64_t StripedMin::value() {
+    int64_t ret = kIdentity;
+    forEachCell([&ret](std::atomic<int64_t>& cell) {
+            ret = std::min(ret, cell.load(std::memory_order_relaxed));
+        });
+    return ret;
+}
+
+void StripedMin::reset() {
+    forEachCell([](std::atomic<int64_t>& cell) {
+            cell.store(kIdentity, std::memory_order_release);
+        });
+}
+
+int64_t StripedMin::getAndReset() {
+    int64_t ret = kIdentity;
+    forEachCell([&ret](std::atomic<int64_t>& cell) {
+            ret = std::min(ret, cell.exchange(kIdentity,
+                std::memory_order_acq_rel));
+        });
+    return ret;
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,105 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_STRIPED_EXTREMUM_H_
+#define SRC_METRICS_STRIPED_EXTREMUM_H_
+
+#include <cinttypes>
+
+#include "metrics/striped_int64.h"
+
+namespace ccmetrics {
+
+/**
+ * A running maximum that stripes updates like Striped64, with which it
+ * shares its stripe expansion and hashing. Each cell holds the maximum of
+ * the updates that landed on it; reads take the maximum over the cells.
+ *
+ * An update that does not exceed its cell is only a load, so once the
+ * maximum has settled, updates do not write to shared cache lines at all.
+ */
+class StripedMax : public Striped64_Base {
+public:
+    /** The value of an empty (or just reset) maximum. */
+    static const int64_t kIdentity = INT64_MIN;
+
+    StripedMax() : Striped64_Base(kIdentity) { }
+    // Basically just for testing
+    explicit StripedMax(size_t k) : Striped64_Base(kIdentity, k) { }
+
+    /** @return the maximum, or kIdentity if there have been no updates. */
+    int64_t value();
+
+    /** Reset to kIdentity. */
+    void reset();
+
+    /**
+     * Reset to kIdentity, returning the maximum drained. No concurrent
+     * update is lost: each is reflected either in the returned value or in
+     * the value that remains.
+     */
+    int64_t getAndReset();
+
+    /** value = max(value, x). */
+    void update(int64_t x) {
+        accumulate<Max>(x);
+    }
+private:
+    struct Max {
+        static int64_t apply(int64_t cur, int64_t x) {
+            return x > cur ? x : cur;
+        }
+    };
+};
+
+/** A running minimum; see StripedMax. */
+class StripedMin : public Striped64_Base {
+public:
+    /** The value of an empty (or just reset) minimum. */
+    static const int64_t kIdentity = INT64_MAX;
+
+    StripedMin() : Striped64_Base(kIdentity) { }
+    // Basically just for testing
+    explicit StripedMin(size_t k) : Striped64_Base(kIdentity, k) { }
+
+    /** @return the minimum, or kIdentity if there have been no updates. */
+    int64_t value();
+
+    /** Reset to kIdentity. */
+    void reset();
+
+    /** Reset to kIdentity, returning the minimum drained; see StripedMax. */
+    int64_t getAndReset();
+
+    /** value = min(value, x). */
+    void update(int64_t x) {
+        accumulate<Min>(x);
+    }
+private:
+    struct Min {
+        static int64_t apply(int64_t cur, int64_t x) {
+            return x < cur ? x : cur;
+        }
+    };
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_STRIPED_EXTREMUM_H_
@@ -22,162 +22,125 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "thread_local_random.h"
 
 namespace ccmetrics {
 
-HazardPointers<Striped64_Storage> Striped64::stripes_pointers_;
-
-ThreadLocal<decltype(Striped64::stripes_pointers_)::pointer_type,
-    Striped64::NewHPFunctor> Striped64::stripes_hazard_(Striped64::NewHPFunctor(),
-        Striped64::retireHazard);
-
-ThreadLocal<size_t, Striped64::NewHashCode> Striped64::thread_hash_code_{
-    Striped64::NewHashCode()};
+ThreadLocal<size_t, Striped64_Base::NewHashCode>
+Striped64_Base::thread_hash_code_{Striped64_Base::NewHashCode()};
 
-size_t* Striped64::NewHashCode::operator()(void) const {
+size_t* Striped64_Base::NewHashCode::operator()(void) const {
     size_t* ret = new size_t(static_cast<size_t>(ThreadLocalRandom::current().next()));
     return ret;
 }
 
-Striped64::~Striped64() {
-    delete stripes_.load();
+Striped64_Base::~Striped64_Base() {
+    // Release the current table and every table it was expanded from
+    Striped64_Storage *cur = stripes_.load();
+    while (cur) {
+        Striped64_Storage *prev = cur->previous();
+        delete cur;
+        cur = prev;
+    }
 }
 
-Striped64::Striped64(size_t k) : base_(0) {
+Striped64_Base::Striped64_Base(int64_t identity, size_t k) : base_(identity),
+        identity_(identity), max_stripes_(0), contention_(0) {
     // Silly. But for testing only.
-    Striped64_Storage *storage = new Striped64_Storage();
+    Striped64_Storage *storage = new Striped64_Storage(identity);
     while (storage->size() < k) {
-        Striped64_Storage *tmp = Striped64_Storage::expand(storage);
-        storage->disavow_all();
-        delete storage;
-        storage = tmp;
+        storage = Striped64_Storage::expand(storage);
     }
     stripes_.store(storage);
 }
 
-int64_t Striped64::value() {
-    Striped64_Storage *cur = nullptr;
-    int64_t ret = base_;
-    do {
-        cur = stripes_.load(std::memory_order_acquire);
-
-        // Short-circuit if there are no stripes; this never transitions
-        // from non-null to null
-        if (!cur) {
-            return ret;
-        }
-
-        // Indicate our intent to dereference the stripes
-        stripes_hazard_->setHazard(cur);
-    } while(stripes_.load(std::memory_order_acquire) != cur);
-
-    size_t cur_len = cur->size();
-    for (size_t i = 0; i < cur_len; ++i) {
-        ret += cur->get(i);
+namespace {
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t ret = 1;
+    while (ret < n) {
+        ret <<= 1;
     }
+    return ret;
+}
+
+size_t hardwareMaxStripes() {
+    static const size_t limit = roundUpToPowerOfTwo(
+        std::max(2U, std::thread::hardware_concurrency()));
+    return limit;
+}
+} // unnamed namespace
 
-    // Release the hazardous reference
-    stripes_hazard_->clearHazard(0);
+// Zero-initialized before any dynamic initialization; 0 means "use hardware"
+std::atomic<size_t> Striped64_Base::default_max_stripes_(0);
 
+void Striped64_Base::setDefaultMaxStripes(size_t max_stripes) {
+    default_max_stripes_.store(max_stripes ? roundUpToPowerOfTwo(max_stripes)
+        : 0, std::memory_order_relaxed);
+}
+
+size_t Striped64_Base::defaultMaxStripes() {
+    size_t ret = default_max_stripes_.load(std::memory_order_relaxed);
+    return ret ? ret : hardwareMaxStripes();
+}
+
+void Striped64_Base::setMaxStripes(size_t max_stripes) {
+    max_stripes_ = static_cast<uint32_t>(
+        max_stripes ? roundUpToPowerOfTwo(max_stripes) : 0);
+}
+
+size_t Striped64_Base::maxStripes() const {
+    return max_stripes_ ? max_stripes_ : defaultMaxStripes();
+}
+
+size_t Striped64_Base::stripes() const {
+    Striped64_Storage *cur = stripes_.load(std::memory_order_acquire);
+    return cur ? cur->size() : 0;
+}
+
+int64_t Striped64::value() {
+    int64_t ret = 0;
+    forEachCell([&ret](std::atomic<int64_t>& cell) {
+            ret += cell.load(std::memory_order_relaxed);
+        });
     return ret;
 }
 
 void Striped64::reset() {
-    base_.store(0, std::memory_order_release);
-    Striped64_Storage *cur = stripes_hazard_->loadAndSetHazard(stripes_, 0);
-    if (!cur) {
-        return;
-    }
-    size_t cur_len = cur->size();
-    for (size_t i = 0; i < cur_len; ++i) {
-        cur->get(i).store(0, std::memory_order_release);
-    }
-    stripes_hazard_->clearHazard(0);
-}
-
-static const int STRIPE_LIMIT = 8; // XXX made up
-
-void Striped64::addSlow(int64_t value, Striped64_Storage *cur,
-        size_t& hash_code) {
-    bool contended = false;
-    bool load = true;
-    auto& hp = *stripes_hazard_;
-    for (;;) {
-        if (!cur) {
-            cur = new Striped64_Storage();
-            Striped64_Storage *none = nullptr;
-            hp.setHazard(0, cur);
-            if (stripes_.compare_exchange_strong(none, cur)) {
-                load = false;
-            } else {
-                delete cur; // NB leave it non-null for next iteration
-                continue;
-            }
-        }
-
-        // Load the current stripes and set a hazard pointer
-        if (load) {
-            cur = hp.loadAndSetHazard(stripes_, 0);
-        }
-
-        // Size is always a power of two
-        size_t idx = hash_code & (cur->size() - 1);
-
-        // 1. Try cas-update. If you succeed, you're done. Otherwise, indicate
-        // contention & rehash & retry once w/o expanding.
-        int64_t expected = cur->get(idx);
-        int64_t update = expected + value;
-        if (cur->get(idx).compare_exchange_strong(expected, update)) {
-            break;
-        }
-
-        if (!contended) {
-            contended = true;
-        } else if (cur->size() < STRIPE_LIMIT) {
-            // You can still grow. Grow.
-            Striped64_Storage *next = Striped64_Storage::expand(cur);
-            if (stripes_.compare_exchange_strong(cur, next)) {
-                // Successfully grew the table; remember to free the existing
-                // and then go do the update again
-                cur->disavow_all();
-                hp.retireNode(cur);
-                // XXX you could have set the hazard and skipped the load on
-                // the next go-round
-            } else {
-                // Raced with somebody else growing the table; release your
-                // allocated storage and retry
-                next->disavow();
-                delete next;
-            }
-            continue;
-        }
-
-        // Remix the hash code
-        hash_code ^= hash_code << 13;
-        hash_code ^= hash_code >> 17;
-        hash_code ^= hash_code << 5;
-    }
+    forEachCell([](std::atomic<int64_t>& cell) {
+            cell.store(0, std::memory_order_release);
+        });
+}
 
-    // Clear the hazard
-    hp.clearHazard(0);
+int64_t Striped64::sumThenReset() {
+    int64_t ret = 0;
+    forEachCell([&ret](std::atomic<int64_t>& cell) {
+            ret += cell.exchange(0, std::memory_order_acq_rel);
+        });
+    return ret;
 }
 
-Striped64_Storage::Striped64_Storage() : clean_created_(true), owner_(true),
-        size_(2) {
-    auto *slab = new CacheAligned<std::atomic<int64_t>>[2];
-    data_ = new CacheAligned<std::atomic<int64_t>>*[2] { slab, slab + 1};
+Striped64_Storage::Striped64_Storage(int64_t identity) : prev_(nullptr),
+        size_(2), identity_(identity) {
+    slab_ = new CacheAligned<std::atomic<int64_t>>[2];
+    data_ = new CacheAligned<std::atomic<int64_t>>*[2] { slab_, slab_ + 1 };
+    for (size_t i = 0; i < size_; ++i) {
+        data_[i]->data.store(identity_, std::memory_order_relaxed);
+    }
 }
 
 Striped64_Storage::Striped64_Storage(Striped64_Storage *other)
-        : clean_created_(true), owner_(true),
-          size_(other->size_ << 1) {
-    size_t slab_size = (other->size_ << 1) - other->size_;
-    auto *slab = new CacheAligned<std::atomic<int64_t>>[slab_size];
+        : prev_(other), size_(other->size_ << 1),
+          identity_(other->identity_) {
+    size_t slab_size = size_ - other->size_;
+    slab_ = new CacheAligned<std::atomic<int64_t>>[slab_size];
     data_ = new CacheAligned<std::atomic<int64_t>>*[size_];
     memcpy(data_, other->data_, other->size_ * sizeof(*other->data_));
     for (size_t i = other->size_, j = 0; i < size_; ++i, ++j) {
-        data_[i] = slab + j;
+        data_[i] = slab_ + j;
+        data_[i]->data.store(identity_, std::memory_order_relaxed);
     }
 }
 
@@ -185,39 +148,8 @@ Striped64_Storage* Striped64_Storage::expand(Striped64_Storage *existing) {
     return new Striped64_Storage(existing);
 }
 
-void Striped64_Storage::disavow() {
-    owner_ = false;
-}
-
-void Striped64_Storage::disavow_all() {
-    owner_ = false;
-    clean_created_ = false;
-}
-
-std::atomic<int64_t>& Striped64_Storage::get(size_t idx) {
-    return data_[idx]->data;
-}
-
 Striped64_Storage::~Striped64_Storage() {
-    int shift = 0;
-    size_t slab = 0;
-    for (;;) {
-        if (owner_ && data_[slab]) {
-            delete [] reinterpret_cast<CacheAligned<std::atomic<int64_t>>*>(
-                data_[slab]);
-        }
-        size_t next_slab = (1 << ++shift);
-        if (next_slab >= size_) {
-            break;
-        }
-        slab = next_slab;
-    }
-
-    if (!owner_ && clean_created_) {
-        // We are responsible for the last block of storage
-        delete [] reinterpret_cast<CacheAligned<std::atomic<int64_t>>*>(
-            data_[slab]);
-    }
+    delete [] slab_;
     delete [] data_;
 }
 
@@ -25,7 +25,6 @@
 #include <cinttypes>
 
 #include "cache_aligned.h"
-#include "hazard_pointers.h"
 #include "thread_local.h"
 
 namespace ccmetrics {
@@ -33,8 +32,9 @@ namespace ccmetrics {
 class Striped64_Storage;
 
 /**
- * A 64-bit signed value that may stripe values across 2+ storage locations
- * to reduce update contention.
+ * The striping machinery shared by Striped64 and its siblings: a base
+ * location and a lazily-created table of 64-bit cells, updated with a CAS
+ * of an accumulation function.
  *
  * Memory access order is not enforced when 2 or more storage locations are
  * used; reads concurrent with multiple writes may observe only some of the
@@ -42,64 +42,153 @@ class Striped64_Storage;
  * intended for uses that can tolerate such inconsistency, such as accumulating
  * values for counter metrics.
  *
+ * Striping is driven by contention: the value starts out as a single base
+ * location, and the stripe table is created and then doubled only once CAS
+ * failures cross a threshold. Failures are decayed on every read or reset,
+ * so that rarely-contended values stay at a single cache line. The table
+ * never grows past a ceiling, which defaults to the hardware concurrency.
+ *
+ * Stripe tables are never reclaimed while the value is live. Expansion
+ * publishes a table twice the size of the current one that shares all of
+ * its existing cells, so a stale table remains a valid (if smaller) view of
+ * the stripes and updates need no hazard pointers. The retired tables are
+ * only arrays of pointers; the total overhead is bounded by the size of the
+ * largest table.
+ *
  * See Doug Lea's [LongAdder](https://docs.oracle.com/javase/8/docs/api/java/
  * util/concurrent/atomic/LongAdder.html), which has been released into the
  * public domain.
  */
-class Striped64 {
+class Striped64_Base {
 public:
+    /**
+     * Override the stripe ceiling for this value, rounding up to a power of
+     * two; 0 restores the global default. Not synchronized with concurrent
+     * updates, so this should be set before the value is shared.
+     */
+    void setMaxStripes(size_t max_stripes);
 
-    Striped64() : base_(0), stripes_(nullptr) { }
-    // Basically just for testing
-    explicit Striped64(size_t k);
-    ~Striped64();
+    /** @return the stripe ceiling for this value. */
+    size_t maxStripes() const;
 
-    /** @return the current value, with consistency caveats as above. */
-    int64_t value();
+    /** @return the number of stripes in use, or 0 if only the base is. */
+    size_t stripes() const;
 
-    /** Reset to zero. */
-    void reset();
+    /**
+     * Set the global default stripe ceiling, rounding up to a power of two;
+     * 0 restores the default of the hardware concurrency.
+     */
+    static void setDefaultMaxStripes(size_t max_stripes);
 
-    /** += value. */
-    void add(int64_t value);
-    void addSlow(int64_t value, Striped64_Storage* cur, size_t &hash_code);
+    /** @return the global default stripe ceiling. */
+    static size_t defaultMaxStripes();
+
+    /** CAS failures after which the stripe table is created or grown. */
+    static const uint32_t kGrowthThreshold = 8;
+protected:
+    explicit Striped64_Base(int64_t identity) : base_(identity),
+        stripes_(nullptr), identity_(identity), max_stripes_(0),
+        contention_(0) { }
+    // Basically just for testing; creates a table of (at least) k stripes
+    Striped64_Base(int64_t identity, size_t k);
+    ~Striped64_Base();
+
+    /**
+     * Fold `x` into one of the cells, where `Op::apply(cell, x)` computes
+     * the updated cell value. Cells are created holding the identity value.
+     * Updates that would leave a cell unchanged skip the CAS, so that e.g.
+     * a running maximum only writes when it grows.
+     */
+    template<typename Op>
+    void accumulate(int64_t x);
+
+    /** Apply `f` to the base and every cell. */
+    template<typename F>
+    void forEachCell(F f);
 private:
+    Striped64_Base(Striped64_Base const&) = delete;
+    Striped64_Base& operator=(Striped64_Base const&) = delete;
+
+    template<typename Op>
+    void accumulateSlow(int64_t x, Striped64_Storage* cur, size_t &hash_code);
+
+    /** Record a CAS failure, returning whether growth is warranted. */
+    bool contended() {
+        return contention_.fetch_add(1, std::memory_order_relaxed) + 1 >=
+            kGrowthThreshold;
+    }
+
+    /** Decay the recorded contention, approximating a recent rate. */
+    void decayContention() {
+        contention_.store(contention_.load(std::memory_order_relaxed) >> 1,
+            std::memory_order_relaxed);
+    }
+
     std::atomic<int64_t> base_;
     std::atomic<Striped64_Storage*> stripes_;
+    // Initial value of newly-created cells
+    const int64_t identity_;
+    // Per-value stripe ceiling, or 0 for the global default
+    uint32_t max_stripes_;
+    // CAS failures since the last growth, decayed by reads
+    std::atomic<uint32_t> contention_;
 
-    static HazardPointers<Striped64_Storage> stripes_pointers_;
-    struct NewHPFunctor {
-        decltype(stripes_pointers_)::pointer_type* operator()(void) const {
-            return stripes_pointers_.allocate();
-        }
-    };
-    static ThreadLocal<decltype(stripes_pointers_)::pointer_type, NewHPFunctor>
-        stripes_hazard_;
+    static std::atomic<size_t> default_max_stripes_;
 
     // TODO: perhaps CRTP-extension of ThreadLocal is a better way?
     struct NewHashCode {
         size_t* operator()(void) const;
     };
     static ThreadLocal<size_t, NewHashCode> thread_hash_code_;
+};
 
-    // Helper for use in releasing thread local stripes_hazard_
-    static void retireHazard(void *h) {
-        stripes_pointers_.retire(
-            reinterpret_cast<decltype(stripes_pointers_)::pointer_type*>(h));
+/**
+ * A 64-bit signed value that may stripe values across 2+ storage locations
+ * to reduce update contention. See Striped64_Base for the consistency
+ * caveats and growth policy.
+ */
+class Striped64 : public Striped64_Base {
+public:
+    Striped64() : Striped64_Base(0) { }
+    // Basically just for testing
+    explicit Striped64(size_t k) : Striped64_Base(0, k) { }
+
+    /** @return the current value, with consistency caveats as above. */
+    int64_t value();
+
+    /** Reset to zero. */
+    void reset();
+
+    /**
+     * Reset to zero, returning the value drained. Unlike `value` followed
+     * by `reset`, no concurrent update is lost: each is reflected either in
+     * the returned value or in the value that remains.
+     */
+    int64_t sumThenReset();
+
+    /** += value. */
+    void add(int64_t value) {
+        accumulate<Add>(value);
     }
+private:
+    struct Add {
+        static int64_t apply(int64_t cur, int64_t x) { return cur + x; }
+    };
 };
 
 // An enormously specialized non-contiguous array-like data structure.
-// See the Striped64::add expansion path for insight.
+// See the Striped64_Base::accumulate expansion path for insight.
 class Striped64_Storage {
 public:
-    Striped64_Storage();
+    explicit Striped64_Storage(int64_t identity = 0);
+
+    /** Releases the elements created by this array (only). */
     ~Striped64_Storage();
 
     /**
-     * Return an array of the next size (2*size), copying and clamining
-     * ownership of elements in the other array. The existing arrary does
-     * not relinquish ownership until disavow_all is invoked.
+     * Return an array of the next size (2*size), sharing the elements of the
+     * existing array and creating the rest. The existing array retains
+     * ownership of its elements and must outlive the returned array.
      */
     static Striped64_Storage* expand(Striped64_Storage *existing);
 
@@ -107,48 +196,137 @@ public:
     size_t size() const { return size_; }
 
     /** @return an array element. */
-    std::atomic<int64_t>& get(size_t idx);
-
-    /** Relinquish ownership of non-created elements in array. */
-    void disavow();
+    std::atomic<int64_t>& get(size_t idx) {
+        return data_[idx]->data;
+    }
 
-    /** Relinquish ownership of all elements in array. */
-    void disavow_all();
+    /** @return the array this one was expanded from, if any. */
+    Striped64_Storage* previous() const { return prev_; }
 private:
     explicit Striped64_Storage(Striped64_Storage *other);
 
-    bool clean_created_;
-    bool owner_;
+    Striped64_Storage(Striped64_Storage const&) = delete;
+    Striped64_Storage& operator=(Striped64_Storage const&) = delete;
+
+    Striped64_Storage *prev_;
     size_t size_;
+    // Initial value of created elements
+    int64_t identity_;
+    // Elements created (and owned) by this array
+    CacheAligned<std::atomic<int64_t>> *slab_;
     CacheAligned<std::atomic<int64_t>> **data_;
 };
 
-inline void Striped64::add(int64_t value) {
+template<typename Op>
+inline void Striped64_Base::accumulate(int64_t x) {
     Striped64_Storage *cur = stripes_.load(std::memory_order_acquire);
     if (!cur) {
         // Attempt to update the base, checking for contention
         int64_t expected = base_.load(std::memory_order_relaxed);
-        int64_t update = expected + value;
-        if (base_.compare_exchange_strong(expected, update)) {
-            // No contention; move along
+        int64_t update = Op::apply(expected, x);
+        if (update == expected ||
+                base_.compare_exchange_strong(expected, update)) {
+            // No change or no contention; move along
             return;
         }
     }
     size_t& hash_code = *thread_hash_code_;
     if (cur) {
-        // Is it really worth it to skip the hazard pointer on the
-        // uncontended case?
-        cur = stripes_hazard_->loadAndSetHazard(stripes_, 0);
+        // Tables are never freed while we're live, so there is no need
+        // to protect `cur` from concurrent expansion
         auto& slot = cur->get(hash_code & (cur->size() - 1));
-        int64_t expected = slot;
-        int64_t update = expected + value;
-        if (slot.compare_exchange_strong(expected, update)) {
-            stripes_hazard_->clearHazard(0);
+        int64_t expected = slot.load(std::memory_order_relaxed);
+        int64_t update = Op::apply(expected, x);
+        if (update == expected ||
+                slot.compare_exchange_strong(expected, update)) {
             return;
         }
     }
     // Slow path
-    addSlow(value, cur, hash_code);
+    accumulateSlow<Op>(x, cur, hash_code);
+}
+
+template<typename Op>
+void Striped64_Base::accumulateSlow(int64_t x, Striped64_Storage *cur,
+        size_t& hash_code) {
+    for (;;) {
+        if (!cur) {
+            // Contended on the base. Keep at it until there has been enough
+            // contention to warrant creating the stripes.
+            int64_t expected = base_.load(std::memory_order_relaxed);
+            int64_t update = Op::apply(expected, x);
+            if (update == expected ||
+                    base_.compare_exchange_strong(expected, update)) {
+                return;
+            }
+
+            if (!contended()) {
+                cur = stripes_.load(std::memory_order_acquire);
+                continue;
+            }
+
+            cur = new Striped64_Storage(identity_);
+            Striped64_Storage *none = nullptr;
+            if (stripes_.compare_exchange_strong(none, cur)) {
+                contention_.store(0, std::memory_order_relaxed);
+            } else {
+                // Lost the race to create the stripes; use the winner's
+                delete cur;
+                cur = none;
+            }
+        }
+
+        // Size is always a power of two
+        size_t idx = hash_code & (cur->size() - 1);
+
+        // 1. Try cas-update. If you succeed, you're done. Otherwise, record
+        // the contention and either grow or rehash & retry.
+        int64_t expected = cur->get(idx);
+        int64_t update = Op::apply(expected, x);
+        if (update == expected ||
+                cur->get(idx).compare_exchange_strong(expected, update)) {
+            break;
+        }
+
+        if (contended() && cur->size() < maxStripes()) {
+            // You can still grow, and there's enough contention to. Grow.
+            Striped64_Storage *next = Striped64_Storage::expand(cur);
+            if (stripes_.compare_exchange_strong(cur, next)) {
+                // Successfully grew the table. The previous table stays
+                // reachable from `next` and is released on destruction.
+                contention_.store(0, std::memory_order_relaxed);
+                cur = next;
+            } else {
+                // Raced with somebody else growing the table; release your
+                // allocated storage and retry with theirs
+                delete next;
+            }
+            continue;
+        }
+
+        // Remix the hash code
+        hash_code ^= hash_code << 13;
+        hash_code ^= hash_code >> 17;
+        hash_code ^= hash_code << 5;
+
+        // Pick up any expansion by another thread
+        cur = stripes_.load(std::memory_order_acquire);
+    }
+}
+
+template<typename F>
+void Striped64_Base::forEachCell(F f) {
+    decayContention();
+
+    f(base_);
+    Striped64_Storage *cur = stripes_.load(std::memory_order_acquire);
+    if (!cur) {
+        return;
+    }
+    size_t cur_len = cur->size();
+    for (size_t i = 0; i < cur_len; ++i) {
+        f(cur->get(i));
+    }
 }
 
 } // ccmetrics namespace
@@ -0,0 +1,70 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/thread_local_int64.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ccmetrics {
+
+ThreadLocal64::ThreadLocal64() : retired_(0), local_(NewCell{this},
+        &ThreadLocal64::retireCell) { }
+
+ThreadLocal64::~ThreadLocal64() {
+    // Cells are released by the destruction of `local_`
+}
+
+ThreadLocal64::AlignedCell* ThreadLocal64::NewCell::operator()(void) const {
+    AlignedCell *cell = new AlignedCell();
+    cell->data.owner = owner;
+
+    std::lock_guard<std::mutex> lock(owner->mutex_);
+    owner->cells_.push_back(cell);
+    return cell;
+}
+
+void ThreadLocal64::retireCell(void *ptr) {
+    AlignedCell *cell = static_cast<AlignedCell*>(ptr);
+    ThreadLocal64 *owner = cell->data.owner;
+
+    {
+        std::lock_guard<std::mutex> lock(owner->mutex_);
+        owner->retired_ += cell->data.value.load(std::memory_order_relaxed);
+        auto it = std::find(owner->cells_.begin(), owner->cells_.end(), cell);
+        assert(it != owner->cells_.end());
+        // Swap-and-pop; cell order is immaterial
+        std::swap(*it, owner->cells_.back());
+        owner->cells_.pop_back();
+    }
+
+    delete cell;
+}
+
+int64_t ThreadLocal64::value() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t ret = retired_;
+    for (AlignedCell *cell : cells_) {
+        ret += cell->data.value.load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,95 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_THREAD_LOCAL_INT64_H_
+#define SRC_METRICS_THREAD_LOCAL_INT64_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <mutex>
+#include <vector>
+
+#include "cache_aligned.h"
+#include "thread_local.h"
+
+namespace ccmetrics {
+
+/**
+ * A 64-bit signed value that keeps a private cell for each updating thread.
+ *
+ * Updates are a relaxed load and store to the calling thread's cell; there
+ * are no read-modify-write instructions and no shared cache lines on the
+ * update path. Reads sum the cells of all live threads plus the values
+ * accumulated from threads that have since exited. As with Striped64, reads
+ * concurrent with updates may observe only some of the updated values.
+ *
+ * The first update from each thread allocates a cell and takes a lock, and
+ * reads are linear in the number of threads that have touched the value, so
+ * this is best suited to long-lived threads (e.g., a fixed worker pool).
+ */
+class ThreadLocal64 {
+public:
+    ThreadLocal64();
+    ~ThreadLocal64();
+
+    /** @return the current value, with consistency caveats as above. */
+    int64_t value();
+
+    /** += value. */
+    void add(int64_t value);
+private:
+    ThreadLocal64(ThreadLocal64 const&) = delete;
+    ThreadLocal64& operator=(ThreadLocal64 const&) = delete;
+
+    struct Cell {
+        Cell() : value(0), owner(nullptr) { }
+        // Only ever written by the owning thread
+        std::atomic<int64_t> value;
+        ThreadLocal64 *owner;
+    };
+    typedef CacheAligned<Cell> AlignedCell;
+
+    struct NewCell {
+        ThreadLocal64 *owner;
+        AlignedCell* operator()(void) const;
+    };
+
+    // Thread exit (or our destruction) hook; folds the cell into `retired_`
+    static void retireCell(void *cell);
+
+    // Guards `cells_` and `retired_`
+    std::mutex mutex_;
+    std::vector<AlignedCell*> cells_;
+    int64_t retired_;
+
+    // NB must be declared last: destroying it retires all live cells
+    ThreadLocal<AlignedCell, NewCell> local_;
+};
+
+inline void ThreadLocal64::add(int64_t value) {
+    // Single writer; no need for an atomic read-modify-write
+    auto& cell = local_->data.value;
+    cell.store(cell.load(std::memory_order_relaxed) + value,
+        std::memory_order_relaxed);
+}
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_THREAD_LOCAL_INT64_H_
@@ -0,0 +1,153 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/tick_clock.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+#include "ccmetrics/clock.h"
+
+namespace ccmetrics {
+
+const bool TickClock::is_steady;
+
+namespace {
+
+TickClock::time_point steadyNow() {
+    return std::chrono::steady_clock::now();
+}
+
+// steady_clock reads CLOCK_MONOTONIC on Linux, so coarse readings are on the
+// same timeline; the coarse clock just skips the vDSO's counter read and
+// advances once per scheduler tick.
+TickClock::time_point coarseNow() {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0) {
+        return TickClock::time_point(
+            std::chrono::duration_cast<TickClock::duration>(
+                std::chrono::seconds(ts.tv_sec) +
+                std::chrono::nanoseconds(ts.tv_nsec)));
+    }
+#endif
+    return steadyNow();
+}
+
+class Refresher {
+public:
+    Refresher() : running_(false),
+        now_(steadyNow().time_since_epoch().count()) { }
+
+    TickClock::time_point now() const {
+        return TickClock::time_point(TickClock::duration(
+            now_.load(std::memory_order_relaxed)));
+    }
+
+    // Guarded by the caller's lock on mutex()
+    void start(std::chrono::microseconds const& refresh) {
+        stop();
+        refresh_ = refresh;
+        running_ = true;
+        refreshNow();
+        thread_ = std::thread([this]() -> void { loop(); });
+    }
+
+    // Guarded by the caller's lock on mutex()
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(cv_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    std::mutex& mutex() { return mutex_; }
+private:
+    void refreshNow() {
+        now_.store(steadyNow().time_since_epoch().count(),
+            std::memory_order_relaxed);
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(cv_mutex_);
+        while (running_) {
+            cv_.wait_for(lock, refresh_);
+            refreshNow();
+        }
+    }
+
+    std::mutex mutex_;    // Serializes source changes
+    std::mutex cv_mutex_; // Guards running_
+    std::condition_variable cv_;
+    bool running_;
+    std::chrono::microseconds refresh_;
+    std::thread thread_;
+    std::atomic<TickClock::rep> now_;
+};
+
+std::atomic<int> tick_source(static_cast<int>(ClockSource::COARSE));
+
+// Created on first use, so that the clock may be set or read during static
+// initialization, and leaked, so that the refresh thread never outlives its
+// state at exit
+Refresher& refresher() {
+    static Refresher *refresher = new Refresher();
+    return *refresher;
+}
+
+} // unnamed namespace
+
+TickClock::time_point TickClock::now() {
+    switch (static_cast<ClockSource>(
+            tick_source.load(std::memory_order_relaxed))) {
+    case ClockSource::COARSE:
+        return coarseNow();
+    case ClockSource::CACHED:
+        return refresher().now();
+    default:
+        return steadyNow();
+    }
+}
+
+void setTickClock(ClockSource source, std::chrono::microseconds refresh) {
+    std::lock_guard<std::mutex> lock(refresher().mutex());
+    if (source == ClockSource::CACHED) {
+        // Start refreshing before anyone reads the cached value
+        refresher().start(refresh);
+        tick_source.store(static_cast<int>(source));
+    } else {
+        tick_source.store(static_cast<int>(source));
+        refresher().stop();
+    }
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,45 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_TICK_CLOCK_H_
+#define SRC_METRICS_TICK_CLOCK_H_
+
+#include <chrono>
+
+namespace ccmetrics {
+
+/**
+ * Clock for timestamps that only need tick or landmark resolution. Reads
+ * whichever source was chosen with `setTickClock`; its time points share
+ * `std::chrono::steady_clock`'s epoch, so the two may be compared.
+ */
+struct TickClock {
+    typedef std::chrono::steady_clock::duration duration;
+    typedef duration::rep rep;
+    typedef duration::period period;
+    typedef std::chrono::steady_clock::time_point time_point;
+    static const bool is_steady = true;
+
+    static time_point now();
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_TICK_CLOCK_H_
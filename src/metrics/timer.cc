@@ -18,15 +18,56 @@
  * SOFTWARE.
  */
 
+#include <stdexcept>
+
 #include "ccmetrics/snapshot.h"
 #include "ccmetrics/timer.h"
+#include "metrics/exponential_reservoir.h"
+#include "metrics/hdr_reservoir.h"
 #include "metrics/histogram.h"
+#include "metrics/interval_reservoir.h"
 #include "metrics/meter_impl.h"
+#include "metrics/sketch_reservoir.h"
+#include "metrics/sliding_count_reservoir.h"
+#include "metrics/sliding_window_reservoir.h"
+#include "metrics/uniform_reservoir.h"
 
 namespace ccmetrics {
 
+namespace {
+Reservoir* mkReservoir(TimerOptions const& options) {
+    if (options.reservoir_factory) {
+        return options.reservoir_factory();
+    }
+    switch (options.reservoir) {
+    case ReservoirType::HDR:
+        return new HdrReservoir(options.hdr_highest,
+            options.hdr_significant_digits);
+    case ReservoirType::INTERVAL:
+        return new IntervalReservoir(options.hdr_highest,
+            options.hdr_significant_digits);
+    case ReservoirType::SLIDING_WINDOW:
+        return new SlidingWindowReservoir(options.window_seconds,
+            options.hdr_highest, options.hdr_significant_digits);
+    case ReservoirType::UNIFORM:
+        return new UniformReservoir(options.reservoir_size);
+    case ReservoirType::SLIDING_COUNT:
+        return new SlidingCountReservoir(options.reservoir_size);
+    case ReservoirType::SKETCH:
+        return new SketchReservoir(options.sketch_accuracy);
+    case ReservoirType::EXPONENTIAL:
+    default:
+        return new ExponentialReservoir(options.reservoir_size,
+            options.decay_alpha);
+    }
+}
+} // unnamed namespace
+
 class TimerImpl {
 public:
+    explicit TimerImpl(TimerOptions const& options)
+        : histogram_(mkReservoir(options)), meter_(options.rates) { }
+
     void update(int64_t duration);
 
     int64_t count() {
@@ -45,9 +86,30 @@ public:
         return meter_.fifteenMinuteRate();
     }
 
+    double rate(int window_seconds) {
+        return meter_.rate(window_seconds);
+    }
+
+    std::vector<int> rateWindows() const {
+        return meter_.rateWindows();
+    }
+
     Snapshot snapshot() {
         return histogram_.snapshot();
     }
+
+    QuantileSketch sketch() {
+        auto *reservoir = dynamic_cast<SketchReservoir*>(
+            histogram_.reservoir());
+        if (!reservoir) {
+            throw std::logic_error("timer does not have a sketch reservoir");
+        }
+        return reservoir->sketch();
+    }
+
+    MeterImpl* meter() {
+        return &meter_;
+    }
 private:
     Histogram histogram_;
     MeterImpl meter_;
@@ -78,11 +140,28 @@ double Timer::fifteenMinuteRate() {
     return impl_->fifteenMinuteRate();
 }
 
+double Timer::rate(int window_seconds) {
+    return impl_->rate(window_seconds);
+}
+
+std::vector<int> Timer::rateWindows() const {
+    return impl_->rateWindows();
+}
+
 Snapshot Timer::snapshot() {
     return impl_->snapshot();
 }
 
-Timer::Timer() : impl_(new TimerImpl()) { }
+QuantileSketch Timer::sketch() {
+    return impl_->sketch();
+}
+
+MeterImpl* Timer::meterImpl() {
+    return impl_->meter();
+}
+
+Timer::Timer() : impl_(new TimerImpl(TimerOptions())) { }
+Timer::Timer(TimerOptions const& options) : impl_(new TimerImpl(options)) { }
 Timer::~Timer() { delete impl_; }
 
 } // ccmetrics namespace
@@ -0,0 +1,72 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "metrics/uniform_reservoir.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "thread_local_random.h"
+
+namespace ccmetrics {
+
+const size_t UniformReservoir::kDefaultSize;
+
+UniformReservoir::UniformReservoir(size_t size) : size_(size), count_(0) {
+    if (size == 0) {
+        throw std::invalid_argument("reservoir size must be positive");
+    }
+    values_ = new std::atomic<int64_t>[size_];
+    for (size_t i = 0; i < size_; ++i) {
+        values_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+UniformReservoir::~UniformReservoir() {
+    delete [] values_;
+}
+
+void UniformReservoir::update(int64_t value) {
+    int64_t n = count_.fetch_add(1, std::memory_order_relaxed);
+    if (n < static_cast<int64_t>(size_)) {
+        values_[n].store(value, std::memory_order_relaxed);
+        return;
+    }
+    // Keep the n-th value with probability size / (n + 1)
+    int64_t r = ThreadLocalRandom::current().next() % (n + 1);
+    if (r < static_cast<int64_t>(size_)) {
+        values_[r].store(value, std::memory_order_relaxed);
+    }
+}
+
+Snapshot UniformReservoir::snapshot() {
+    size_t n = static_cast<size_t>(std::min<int64_t>(
+        count_.load(std::memory_order_relaxed), size_));
+    std::vector<int64_t> values = Snapshot::buffer();
+    values.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = values_[i].load(std::memory_order_relaxed);
+    }
+    return Snapshot(std::move(values), /*sorted=*/ false);
+}
+
+} // ccmetrics namespace
@@ -0,0 +1,64 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_METRICS_UNIFORM_RESERVOIR_H_
+#define SRC_METRICS_UNIFORM_RESERVOIR_H_
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+
+#include "ccmetrics/reservoir.h"
+#include "ccmetrics/snapshot.h"
+
+namespace ccmetrics {
+
+/**
+ * A uniform sample of all recorded values, using Vitter's Algorithm R [1].
+ *
+ * An update is an atomic increment of the value count, at most one random
+ * draw, and at most one atomic store into a fixed array; there is no
+ * allocation or decay. Concurrent updates choosing the same slot race, and
+ * either value may be kept. Snapshots concurrent with updates may observe
+ * a slot that has been claimed but not yet written.
+ *
+ * [1] J. Vitter, "Random Sampling with a Reservoir." ACM TOMS, 1985.
+ */
+class UniformReservoir final : public Reservoir {
+public:
+    static const size_t kDefaultSize = 1028;
+
+    explicit UniformReservoir(size_t size = kDefaultSize);
+    ~UniformReservoir();
+
+    void update(int64_t value) override;
+    Snapshot snapshot() override;
+private:
+    UniformReservoir(UniformReservoir const&) = delete;
+    UniformReservoir& operator=(UniformReservoir const&) = delete;
+
+    const size_t size_;
+    std::atomic<int64_t> count_;
+    std::atomic<int64_t> *values_;
+};
+
+} // ccmetrics namespace
+
+#endif // SRC_METRICS_UNIFORM_RESERVOIR_H_
@@ -45,6 +45,11 @@ private:
     void printCounter(Counter *ctr);
     void printTimer(Timer *timer);
     void printMeter(Meter *meter);
+    void printSum(Sum *sum);
+    void printGauge(Gauge *gauge);
+    void printGauge(DoubleGauge *gauge);
+    void printGauge(MaxGauge *gauge);
+    void printGauge(MinGauge *gauge);
 
     const MetricRegistry *registry_;
 };
@@ -67,6 +72,17 @@ void printFormatted(const char *lhs, const char *equality, int64_t value,
         equality, value, rhs);
 }
 
+// e.g. "5-minute rate", or "30-second rate" for windows of odd seconds
+static std::string rateLabel(int window_seconds) {
+    std::ostringstream ss;
+    if (window_seconds % 60 == 0) {
+        ss << window_seconds / 60 << "-minute rate";
+    } else {
+        ss << window_seconds << "-second rate";
+    }
+    return ss.str();
+}
+
 static std::string formatNow() {
     std::time_t t = std::time(nullptr);
 #if defined(__APPLE__) || defined(_WIN32)
@@ -115,6 +131,42 @@ void ConsoleReporter::report() NOEXCEPT {
         printf("\n");
 
     }
+
+    auto sums = registry_->sums();
+    if (!sums.empty()) {
+        printWithBanner("-- Sums", '-');
+        for (auto& entry : sums) {
+            printf("%s\n", entry.first.c_str());
+            printSum(entry.second);
+        }
+        printf("\n");
+    }
+
+    auto gauges = registry_->gauges();
+    auto double_gauges = registry_->doubleGauges();
+    auto max_gauges = registry_->maxGauges();
+    auto min_gauges = registry_->minGauges();
+    if (!gauges.empty() || !double_gauges.empty() || !max_gauges.empty() ||
+            !min_gauges.empty()) {
+        printWithBanner("-- Gauges", '-');
+        for (auto& entry : gauges) {
+            printf("%s\n", entry.first.c_str());
+            printGauge(entry.second);
+        }
+        for (auto& entry : double_gauges) {
+            printf("%s\n", entry.first.c_str());
+            printGauge(entry.second);
+        }
+        for (auto& entry : max_gauges) {
+            printf("%s\n", entry.first.c_str());
+            printGauge(entry.second);
+        }
+        for (auto& entry : min_gauges) {
+            printf("%s\n", entry.first.c_str());
+            printGauge(entry.second);
+        }
+        printf("\n");
+    }
 }
 
 void ConsoleReporter::printCounter(Counter *counter) {
@@ -122,27 +174,51 @@ void ConsoleReporter::printCounter(Counter *counter) {
 }
 
 void ConsoleReporter::printTimer(Timer *timer) {
-    auto snap = timer->snapshot();
+    auto summary = timer->snapshot().summarize(
+        {0.5, 0.75, 0.95, 0.99, 0.999});
     printFormatted("count", "=", timer->count(), "");
-    printFormatted("1-minute rate", "=", timer->oneMinuteRate(), "calls/s");
-    printFormatted("5-minute rate", "=", timer->fiveMinuteRate(), "calls/s");
-    printFormatted("15-minute rate", "=", timer->fifteenMinuteRate(), "calls/s");
-
-    printFormatted("min", "=", snap.min(), "us");
-    printFormatted("max", "=", snap.max(), "us");
-    printFormatted("mean", "=", snap.mean(), "us");
-    printFormatted("stdev", "=", snap.stdev(), "us");
-    printFormatted("median", "=", snap.median(), "us");
-    printFormatted("75%", "<=", snap.get75tile(), "us");
-    printFormatted("95%", "<=", snap.get95tile(), "us");
-    printFormatted("99%", "<=", snap.get99tile(), "us");
-    printFormatted("99.9%", "<=", snap.get999tile(), "us");
+    for (int window : timer->rateWindows()) {
+        printFormatted(rateLabel(window).c_str(), "=", timer->rate(window),
+            "calls/s");
+    }
+
+    printFormatted("min", "=", summary.min, "us");
+    printFormatted("max", "=", summary.max, "us");
+    printFormatted("mean", "=", summary.mean, "us");
+    printFormatted("stdev", "=", summary.stdev, "us");
+    printFormatted("median", "=", summary.quantiles[0], "us");
+    printFormatted("75%", "<=", summary.quantiles[1], "us");
+    printFormatted("95%", "<=", summary.quantiles[2], "us");
+    printFormatted("99%", "<=", summary.quantiles[3], "us");
+    printFormatted("99.9%", "<=", summary.quantiles[4], "us");
 }
 
 void ConsoleReporter::printMeter(Meter *meter) {
-    printFormatted("1-minute rate", "=", meter->oneMinuteRate(), "/s");
-    printFormatted("5-minute rate", "=", meter->fiveMinuteRate(), "/s");
-    printFormatted("15-minute rate", "=", meter->fifteenMinuteRate(), "/s");
+    for (int window : meter->rateWindows()) {
+        printFormatted(rateLabel(window).c_str(), "=", meter->rate(window),
+            "/s");
+    }
+}
+
+void ConsoleReporter::printSum(Sum *sum) {
+    printFormatted("sum", "=", sum->value(), "");
+}
+
+void ConsoleReporter::printGauge(Gauge *gauge) {
+    printFormatted("value", "=", gauge->value(), "");
+}
+
+void ConsoleReporter::printGauge(DoubleGauge *gauge) {
+    printFormatted("value", "=", gauge->value(), "");
+}
+
+// Water marks are only read; see MetricRegistry::resetWaterMarks
+void ConsoleReporter::printGauge(MaxGauge *gauge) {
+    printFormatted("max", "=", gauge->value(), "");
+}
+
+void ConsoleReporter::printGauge(MinGauge *gauge) {
+    printFormatted("min", "=", gauge->value(), "");
 }
 
 void ConsoleReporter::printWithBanner(std::string const& str, char sym) {
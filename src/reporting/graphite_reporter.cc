@@ -73,11 +73,29 @@ private:
         Timer *timer, int64_t timestamp);
     void writeMeter(wte::Buffer *buffer, std::string const& name,
         Meter *meter, int64_t timestamp);
+    void writeSum(wte::Buffer *buffer, std::string const& name,
+        Sum *sum, int64_t timestamp);
+    void writeGauge(wte::Buffer *buffer, std::string const& name,
+        Gauge *gauge, int64_t timestamp);
+    void writeGauge(wte::Buffer *buffer, std::string const& name,
+        DoubleGauge *gauge, int64_t timestamp);
+    void writeGauge(wte::Buffer *buffer, std::string const& name,
+        MaxGauge *gauge, int64_t timestamp);
+    void writeGauge(wte::Buffer *buffer, std::string const& name,
+        MinGauge *gauge, int64_t timestamp);
 
     std::string prefix(std::string const& name, std::string const& val) {
         return name + "." + val;
     }
 
+    // e.g. "m5_rate", or "rate_30s" for windows of odd seconds
+    std::string rateKey(int window_seconds) {
+        if (window_seconds % 60 == 0) {
+            return fmt::format("m{}_rate", window_seconds / 60);
+        }
+        return fmt::format("rate_{}s", window_seconds);
+    }
+
     WriteCallback wcb_;
     ConnectCallback ccb_;
     State state_;
@@ -141,47 +159,75 @@ void GraphiteReporter::writeTimer(wte::Buffer *buffer,
         std::string const& name, Timer *timer, int64_t ts) {
     std::string f;
 
-    auto snap = timer->snapshot();
+    auto summary = timer->snapshot().summarize(
+        {0.5, 0.75, 0.95, 0.99, 0.999});
 
     buffer->append(fmt::format("{} {} {}\n",
         prefix(name, "count"), timer->count(), ts));
-    buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "m1_rate"), timer->oneMinuteRate(), ts));
-    buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "m5_rate"), timer->fiveMinuteRate(), ts));
-    buffer->append(fmt::format("{} {:2.2f} {} \n",
-        prefix(name, "m15_rate"), timer->fifteenMinuteRate(), ts));
+    for (int window : timer->rateWindows()) {
+        buffer->append(fmt::format("{} {:2.2f} {}\n",
+            prefix(name, rateKey(window)), timer->rate(window), ts));
+    }
 
     buffer->append(fmt::format("{} {} {}\n",
-        prefix(name, "min"), snap.min(), ts));
+        prefix(name, "min"), summary.min, ts));
     buffer->append(fmt::format("{} {} {}\n",
-        prefix(name, "max"), snap.max(), ts));
+        prefix(name, "max"), summary.max, ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "mean"), snap.mean(), ts));
+        prefix(name, "mean"), summary.mean, ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "stdev"), snap.stdev(), ts));
+        prefix(name, "stdev"), summary.stdev, ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "median"), snap.median(), ts));
+        prefix(name, "median"), summary.quantiles[0], ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "p75"), snap.get75tile(), ts));
+        prefix(name, "p75"), summary.quantiles[1], ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "p95"), snap.get95tile(), ts));
+        prefix(name, "p95"), summary.quantiles[2], ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "p99"), snap.get99tile(), ts));
+        prefix(name, "p99"), summary.quantiles[3], ts));
     buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "p999"), snap.get999tile(), ts));
+        prefix(name, "p999"), summary.quantiles[4], ts));
 }
 
 void GraphiteReporter::writeMeter(wte::Buffer *buffer,
         std::string const& name, Meter *meter, int64_t ts) {
     std::string f;
 
-    buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "m1_rate"), meter->oneMinuteRate(), ts));
-    buffer->append(fmt::format("{} {:2.2f} {}\n",
-        prefix(name, "m5_rate"), meter->fiveMinuteRate(), ts));
-    buffer->append(fmt::format("{} {:2.2f} {} \n",
-        prefix(name, "m15_rate"), meter->fifteenMinuteRate(), ts));
+    for (int window : meter->rateWindows()) {
+        buffer->append(fmt::format("{} {:2.2f} {}\n",
+            prefix(name, rateKey(window)), meter->rate(window), ts));
+    }
+}
+
+void GraphiteReporter::writeSum(wte::Buffer *buffer,
+        std::string const& name, Sum *sum, int64_t ts) {
+    buffer->append(fmt::format("{} {} {}\n", prefix(name, "sum"),
+        sum->value(), ts));
+}
+
+void GraphiteReporter::writeGauge(wte::Buffer *buffer,
+        std::string const& name, Gauge *gauge, int64_t ts) {
+    buffer->append(fmt::format("{} {} {}\n", prefix(name, "value"),
+        gauge->value(), ts));
+}
+
+void GraphiteReporter::writeGauge(wte::Buffer *buffer,
+        std::string const& name, DoubleGauge *gauge, int64_t ts) {
+    buffer->append(fmt::format("{} {} {}\n", prefix(name, "value"),
+        gauge->value(), ts));
+}
+
+// Water marks are only read; see MetricRegistry::resetWaterMarks
+void GraphiteReporter::writeGauge(wte::Buffer *buffer,
+        std::string const& name, MaxGauge *gauge, int64_t ts) {
+    buffer->append(fmt::format("{} {} {}\n", prefix(name, "max"),
+        gauge->value(), ts));
+}
+
+void GraphiteReporter::writeGauge(wte::Buffer *buffer,
+        std::string const& name, MinGauge *gauge, int64_t ts) {
+    buffer->append(fmt::format("{} {} {}\n", prefix(name, "min"),
+        gauge->value(), ts));
 }
 
 void GraphiteReporter::report() NOEXCEPT {
@@ -214,6 +260,31 @@ void GraphiteReporter::report() NOEXCEPT {
         writeMeter(writebuf.get(), entry.first, entry.second,  unix_timestamp);
     }
 
+    auto sums = registry_->sums();
+    for (auto& entry : sums) {
+        writeSum(writebuf.get(), entry.first, entry.second, unix_timestamp);
+    }
+
+    auto gauges = registry_->gauges();
+    for (auto& entry : gauges) {
+        writeGauge(writebuf.get(), entry.first, entry.second, unix_timestamp);
+    }
+
+    auto double_gauges = registry_->doubleGauges();
+    for (auto& entry : double_gauges) {
+        writeGauge(writebuf.get(), entry.first, entry.second, unix_timestamp);
+    }
+
+    auto max_gauges = registry_->maxGauges();
+    for (auto& entry : max_gauges) {
+        writeGauge(writebuf.get(), entry.first, entry.second, unix_timestamp);
+    }
+
+    auto min_gauges = registry_->minGauges();
+    for (auto& entry : min_gauges) {
+        writeGauge(writebuf.get(), entry.first, entry.second, unix_timestamp);
+    }
+
     // XXX ew. Fix this in wte.
     stream_->write(writebuf.get(), &wcb_);
 }
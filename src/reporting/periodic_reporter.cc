@@ -37,7 +37,7 @@ class PeriodicReporterImpl {
 public:
     PeriodicReporterImpl(PeriodicReporter *reporter)
         : reporter_(reporter), base_(wte::mkEventBase()), timeout_(this),
-          running_(false) { }
+          running_(false), reset_registry_(nullptr) { }
     ~PeriodicReporterImpl() { }
 
     class ReporterTimeout final : public wte::Timeout {
@@ -49,8 +49,11 @@ public:
             // Re-register beofre reporting to maintain consistent period
             reporterImpl_->base_->registerTimeout(this, &tv_);
 
-            // Report
+            // Report, then start the next period's water marks
             reporterImpl_->reporter_->report();
+            if (reporterImpl_->reset_registry_) {
+                reporterImpl_->reset_registry_->resetWaterMarks();
+            }
         }
 
         void setTimeoutAndSchedule(std::chrono::milliseconds const& ms) {
@@ -67,6 +70,11 @@ public:
         return running_;
     }
 
+    void resetWaterMarksAfterReport(MetricRegistry *registry) {
+        assert(!running_);
+        reset_registry_ = registry;
+    }
+
     void stop() {
         base_->runOnEventLoopAndWait([this]() -> void {
                 base_->unregisterTimeout(&timeout_);
@@ -96,6 +104,9 @@ private:
     bool running_;
     std::thread loop_;
 
+    // Set before starting, so read by the loop without synchronization
+    MetricRegistry *reset_registry_;
+
     friend std::shared_ptr<wte::EventBase> getReporterBase(
         PeriodicReporterImpl *);
 };
@@ -114,6 +125,10 @@ void PeriodicReporter::stop() {
     impl_->stop();
 }
 
+void PeriodicReporter::resetWaterMarksAfterReport(MetricRegistry *registry) {
+    impl_->resetWaterMarksAfterReport(registry);
+}
+
 void PeriodicReporter::Deleter::operator()(PeriodicReporter *reporter) {
     delete reporter;
 }
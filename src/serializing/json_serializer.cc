@@ -20,6 +20,9 @@
 
 #include "ccmetrics/serializing/json_serializer.h"
 
+#include <map>
+#include <string>
+
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
@@ -42,6 +45,14 @@ void writeNumeric(Writer &writer, std::string const& key, double value) {
     writer.Double(value);
 }
 
+// e.g. "m5_rate", or "rate_30s" for windows of odd seconds
+std::string rateKey(int window_seconds) {
+    if (window_seconds % 60 == 0) {
+        return "m" + std::to_string(window_seconds / 60) + "_rate";
+    }
+    return "rate_" + std::to_string(window_seconds) + "s";
+}
+
 template<typename Writer>
 void serialize_helper(Timer *timer, Writer &writer) {
     // us -> s
@@ -49,23 +60,24 @@ void serialize_helper(Timer *timer, Writer &writer) {
 
     writer.StartObject();
 
-    Snapshot snap = timer->snapshot();
+    Snapshot::Summary summary = timer->snapshot().summarize(
+        {0.5, 0.75, 0.95, 0.99, 0.999});
 
     writeNumeric(writer, "count", timer->count());
-    writeNumeric(writer, "max", snap.max() * kFactor);
-    writeNumeric(writer, "mean", snap.mean() * kFactor);
-    writeNumeric(writer, "min", snap.min() * kFactor);
+    writeNumeric(writer, "max", summary.max * kFactor);
+    writeNumeric(writer, "mean", summary.mean * kFactor);
+    writeNumeric(writer, "min", summary.min * kFactor);
 
-    writeNumeric(writer, "p50", snap.median() * kFactor);
-    writeNumeric(writer, "p75", snap.get75tile() * kFactor);
-    writeNumeric(writer, "p95", snap.get95tile() * kFactor);
-    writeNumeric(writer, "p99", snap.get99tile() * kFactor);
-    writeNumeric(writer, "p999", snap.get999tile() * kFactor);
+    writeNumeric(writer, "p50", summary.quantiles[0] * kFactor);
+    writeNumeric(writer, "p75", summary.quantiles[1] * kFactor);
+    writeNumeric(writer, "p95", summary.quantiles[2] * kFactor);
+    writeNumeric(writer, "p99", summary.quantiles[3] * kFactor);
+    writeNumeric(writer, "p999", summary.quantiles[4] * kFactor);
 
-    writeNumeric(writer, "stdev", snap.stdev() * kFactor);
-    writeNumeric(writer, "m15_rate", timer->fifteenMinuteRate());
-    writeNumeric(writer, "m5_rate", timer->fiveMinuteRate());
-    writeNumeric(writer, "m1_rate", timer->oneMinuteRate());
+    writeNumeric(writer, "stdev", summary.stdev * kFactor);
+    for (int window : timer->rateWindows()) {
+        writeNumeric(writer, rateKey(window), timer->rate(window));
+    }
 
     writer.EndObject();
 }
@@ -79,6 +91,64 @@ void serialize_helper(Counter *counter, Writer &writer) {
     writer.EndObject();
 }
 
+template<typename Writer>
+void serialize_helper(Sum *sum, Writer &writer) {
+    writer.StartObject();
+
+    writeNumeric(writer, "sum", sum->value());
+
+    writer.EndObject();
+}
+
+template<typename Writer>
+void serialize_helper(Gauge *gauge, Writer &writer) {
+    writer.StartObject();
+
+    writeNumeric(writer, "value", gauge->value());
+
+    writer.EndObject();
+}
+
+template<typename Writer>
+void serialize_helper(DoubleGauge *gauge, Writer &writer) {
+    writer.StartObject();
+
+    writeNumeric(writer, "value", gauge->value());
+
+    writer.EndObject();
+}
+
+// Serialization is a read, so water marks are not reset here
+template<typename Writer>
+void serialize_helper(MaxGauge *gauge, Writer &writer) {
+    writer.StartObject();
+
+    writeNumeric(writer, "max", gauge->value());
+
+    writer.EndObject();
+}
+
+template<typename Writer>
+void serialize_helper(MinGauge *gauge, Writer &writer) {
+    writer.StartObject();
+
+    writeNumeric(writer, "min", gauge->value());
+
+    writer.EndObject();
+}
+
+template<typename Writer, typename T>
+void serialize_section(Writer &writer, const char *key,
+        std::map<std::string, T*> const& metrics) {
+    writer.String(key);
+    writer.StartObject();
+    for (auto const& entry : metrics) {
+        writer.String(entry.first.c_str());
+        serialize_helper(entry.second, writer);
+    }
+    writer.EndObject();
+}
+
 } // unnamed namespace
 
 std::string JsonSerializer::do_serialize(Timer *timer) {
@@ -99,6 +169,51 @@ std::string JsonSerializer::do_serialize(Counter *counter) {
     return buffer.GetString();
 }
 
+std::string JsonSerializer::do_serialize(Sum *sum) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    serialize_helper(sum, writer);
+
+    return buffer.GetString();
+}
+
+std::string JsonSerializer::do_serialize(Gauge *gauge) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    serialize_helper(gauge, writer);
+
+    return buffer.GetString();
+}
+
+std::string JsonSerializer::do_serialize(DoubleGauge *gauge) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    serialize_helper(gauge, writer);
+
+    return buffer.GetString();
+}
+
+std::string JsonSerializer::do_serialize(MaxGauge *gauge) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    serialize_helper(gauge, writer);
+
+    return buffer.GetString();
+}
+
+std::string JsonSerializer::do_serialize(MinGauge *gauge) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    serialize_helper(gauge, writer);
+
+    return buffer.GetString();
+}
+
 std::string JsonSerializer::do_serialize(MetricRegistry *registry) {
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
@@ -121,6 +236,32 @@ std::string JsonSerializer::do_serialize(MetricRegistry *registry) {
     }
     writer.EndObject();
 
+    // Optional sections are omitted when empty
+    auto sums = registry->sums();
+    if (!sums.empty()) {
+        serialize_section(writer, "sums", sums);
+    }
+
+    auto gauges = registry->gauges();
+    if (!gauges.empty()) {
+        serialize_section(writer, "gauges", gauges);
+    }
+
+    auto double_gauges = registry->doubleGauges();
+    if (!double_gauges.empty()) {
+        serialize_section(writer, "double_gauges", double_gauges);
+    }
+
+    auto max_gauges = registry->maxGauges();
+    if (!max_gauges.empty()) {
+        serialize_section(writer, "max_gauges", max_gauges);
+    }
+
+    auto min_gauges = registry->minGauges();
+    if (!min_gauges.empty()) {
+        serialize_section(writer, "min_gauges", min_gauges);
+    }
+
     writer.EndObject();
     return buffer.GetString();
 }
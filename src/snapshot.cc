@@ -22,51 +22,332 @@
 
 #include <algorithm>
 #include <cmath>
-#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+
+#include "snapshot_kernels.h"
 
 namespace ccmetrics {
 
+namespace {
+// Uses R-7 (default in R, and also in S), linear interpoloation of the
+// modes for the order statistics of U[0, 1]. `nth` returns the value at a
+// zero-based rank of the `n` observations.
+template<typename F>
+double interpolate(double quantile, size_t n, F const& nth) {
+    double idx = quantile * (n + 1);
+
+    if (idx < 1) {
+        return nth(0);
+    } else if (idx >= n) {
+        return nth(n - 1);
+    }
+
+    double x_h = nth(static_cast<size_t>(idx - 1));
+    double x_hnext = nth(static_cast<size_t>(idx));
+    return x_h + (idx - ::floor(idx)) * (x_hnext - x_h);
+}
+
+// Partially orders [begin, end) so that each of the (sorted, distinct)
+// ranks in [rbegin, rend) holds its order statistic. Selecting the median
+// rank first splits the remaining work in two, so the cost is O(n log k)
+// for k ranks rather than the O(n log n) of a full sort.
+void multiSelect(std::vector<int64_t>::iterator base,
+        std::vector<int64_t>::iterator begin,
+        std::vector<int64_t>::iterator end,
+        std::vector<size_t>::const_iterator rbegin,
+        std::vector<size_t>::const_iterator rend) {
+    if (rbegin == rend || end - begin < 2) {
+        return;
+    }
+    auto mid = rbegin + (rend - rbegin) / 2;
+    auto nth = base + *mid;
+    std::nth_element(begin, nth, end);
+    multiSelect(base, begin, nth, rbegin, mid);
+    multiSelect(base, nth + 1, end, mid + 1, rend);
+}
+// Recycled snapshot storage. Reporting takes a snapshot of every timer each
+// interval, which would otherwise allocate and free a few vectors per timer.
+// Vectors are pooled by pointer, so that a snapshot's own storage is reused
+// as well as the buffers its values are built in: `full_` holds vectors with
+// capacity, for `Snapshot::buffer`, and `empty_` holds the vectors those were
+// moved out of, for wrapping the buffers once built.
+class BufferPool {
+public:
+    // Bounds the memory held by each list when many snapshots are released
+    // at once, e.g. after a reporter holding all of them finishes.
+    static const size_t kMaxPooled = 128;
+
+    // Reserved, so that releasing never allocates
+    BufferPool() {
+        full_.reserve(kMaxPooled);
+        empty_.reserve(kMaxPooled);
+    }
+
+    std::vector<int64_t> buffer() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (full_.empty()) {
+            return std::vector<int64_t>();
+        }
+        std::vector<int64_t> *vec = full_.back();
+        full_.pop_back();
+        std::vector<int64_t> ret(std::move(*vec));
+        vec->clear();
+        put(&empty_, vec);
+        return ret;
+    }
+
+    std::vector<int64_t>* wrap(std::vector<int64_t> &&buffer) {
+        std::vector<int64_t> *vec = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!empty_.empty()) {
+                vec = empty_.back();
+                empty_.pop_back();
+            }
+        }
+        if (!vec) {
+            return new std::vector<int64_t>(std::move(buffer));
+        }
+        *vec = std::move(buffer);
+        return vec;
+    }
+
+    void release(std::vector<int64_t> *vec) {
+        vec->clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        put(vec->capacity() > 0 ? &full_ : &empty_, vec);
+    }
+private:
+    static void put(std::vector<std::vector<int64_t>*> *list,
+            std::vector<int64_t> *vec) {
+        if (list->size() < kMaxPooled) {
+            list->push_back(vec);
+        } else {
+            delete vec;
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<std::vector<int64_t>*> full_;
+    std::vector<std::vector<int64_t>*> empty_;
+};
+
+// Never destroyed, so that snapshots may outlive static destruction
+BufferPool *const kPool = new BufferPool();
+
+// Shared by every empty and moved-from snapshot, and never pooled, so that
+// neither construction nor moves touch the pool. Empty snapshots never
+// write to their values.
+std::vector<int64_t>* emptyValues() {
+    static std::vector<int64_t> kEmpty;
+    return &kEmpty;
+}
+
+void releaseStorage(std::vector<int64_t> *values,
+        std::vector<int64_t> *ranks) {
+    if (values != emptyValues()) {
+        kPool->release(values);
+    }
+    if (ranks) {
+        kPool->release(ranks);
+    }
+}
+
+std::vector<int64_t>* copyOf(std::vector<int64_t> const& from) {
+    std::vector<int64_t> buffer = kPool->buffer();
+    buffer.assign(from.begin(), from.end());
+    return kPool->wrap(std::move(buffer));
+}
+} // unnamed namespace
+
+std::vector<int64_t> Snapshot::buffer() {
+    return kPool->buffer();
+}
+
+void Snapshot::recycle(std::vector<int64_t> &&buffer) {
+    kPool->release(kPool->wrap(std::move(buffer)));
+}
+
+Snapshot::Snapshot()
+        : values_(emptyValues()), ranks_(nullptr), sorted_(true) { }
+
 Snapshot::Snapshot(std::vector<int64_t> &&values, bool sorted)
-        : values_(new std::vector<int64_t>(std::move(values))) {
-    if (!sorted) {
-        std::sort(values_->begin(), values_->end());
+        : values_(kPool->wrap(std::move(values))), ranks_(nullptr),
+          sorted_(sorted) { }
+
+Snapshot::Snapshot(std::vector<int64_t> &&values,
+        std::vector<int64_t> &&counts)
+        : values_(kPool->wrap(std::move(values))),
+          ranks_(kPool->wrap(std::move(counts))), sorted_(true) {
+    int64_t total = 0;
+    for (int64_t& count : *ranks_) {
+        total += count;
+        count = total;
     }
 }
 
 Snapshot::~Snapshot() {
-    delete values_;
+    releaseStorage(values_, ranks_);
 }
 
-double Snapshot::mean() const {
-    if (values_->empty()) {
-        return 0;
+Snapshot::Snapshot(Snapshot const& other)
+        : values_(copyOf(*other.values_)),
+          ranks_(other.ranks_ ? copyOf(*other.ranks_) : nullptr),
+          sorted_(other.sorted_) { }
+
+Snapshot& Snapshot::operator=(Snapshot const& other) {
+    if (this != &other) {
+        Snapshot copy(other);
+        *this = std::move(copy);
     }
+    return *this;
+}
 
-    int64_t sum = 0;
-    for (int64_t v : *values_) {
-        sum += v;
+Snapshot::Snapshot(Snapshot &&other) NOEXCEPT
+        : values_(other.values_), ranks_(other.ranks_),
+          sorted_(other.sorted_) {
+    other.values_ = emptyValues();
+    other.ranks_ = nullptr;
+    other.sorted_ = true;
+}
+
+Snapshot& Snapshot::operator=(Snapshot &&other) NOEXCEPT {
+    if (this != &other) {
+        releaseStorage(values_, ranks_);
+        values_ = other.values_;
+        ranks_ = other.ranks_;
+        sorted_ = other.sorted_;
+        other.values_ = emptyValues();
+        other.ranks_ = nullptr;
+        other.sorted_ = true;
     }
-    return sum / static_cast<double>(values_->size());
+    return *this;
 }
 
-double Snapshot::stdev() const {
-    // Wellford's algorithm (numerically stable online variance)
-    int n = 0;
-    int64_t varsum = 0;
-    double mean = 0.0;
-    for (int64_t value : *values_) {
-        ++n;
-        double delta = value - mean;
-        mean += delta / n;
-        varsum += delta * (value - mean);
+Snapshot Snapshot::merge(std::vector<Snapshot> const& snapshots) {
+    // Heads of each input, ordered to make a min-heap by value
+    struct Cursor {
+        int64_t value;
+        size_t input;
+        size_t pos;
+        bool operator>(Cursor const& other) const {
+            return value > other.value;
+        }
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>>
+        heads;
+
+    bool weighted = false;
+    size_t total = 0;
+    for (size_t i = 0; i < snapshots.size(); ++i) {
+        Snapshot const& snap = snapshots[i];
+        snap.ensureSorted();
+        weighted |= snap.ranks_ != nullptr;
+        total += snap.values_->size();
+        if (!snap.values_->empty()) {
+            heads.push(Cursor{snap.values_->front(), i, 0});
+        }
+    }
+
+    std::vector<int64_t> values = buffer();
+    std::vector<int64_t> counts;
+    values.reserve(total);
+    if (weighted) {
+        counts = buffer();
+        counts.reserve(total);
+    }
+
+    while (!heads.empty()) {
+        Cursor cur = heads.top();
+        heads.pop();
+
+        Snapshot const& snap = snapshots[cur.input];
+        if (weighted) {
+            int64_t count = 1;
+            if (snap.ranks_) {
+                count = (*snap.ranks_)[cur.pos] -
+                    (cur.pos > 0 ? (*snap.ranks_)[cur.pos - 1] : 0);
+            }
+            // Equal values from different inputs share a bucket
+            if (!values.empty() && values.back() == cur.value) {
+                counts.back() += count;
+            } else {
+                values.push_back(cur.value);
+                counts.push_back(count);
+            }
+        } else {
+            values.push_back(cur.value);
+        }
+
+        if (++cur.pos < snap.values_->size()) {
+            cur.value = (*snap.values_)[cur.pos];
+            heads.push(cur);
+        }
+    }
+
+    if (weighted) {
+        return Snapshot(std::move(values), std::move(counts));
+    }
+    return Snapshot(std::move(values), /*sorted=*/ true);
+}
+
+void Snapshot::ensureSorted() const {
+    if (!sorted_) {
+        std::sort(values_->begin(), values_->end());
+        sorted_ = true;
+    }
+}
+
+size_t Snapshot::size() const {
+    if (ranks_) {
+        return ranks_->empty() ? 0 : static_cast<size_t>(ranks_->back());
+    }
+    return values_->size();
+}
+
+int64_t Snapshot::nth(size_t rank) const {
+    if (!ranks_) {
+        return (*values_)[rank];
+    }
+    // The first value whose cumulative count covers the rank
+    auto it = std::upper_bound(ranks_->begin(), ranks_->end(),
+        static_cast<int64_t>(rank));
+    return (*values_)[it - ranks_->begin()];
+}
+
+int64_t Snapshot::min() const {
+    if (values_->empty()) {
+        return 0;
+    } else if (!sorted_) {
+        return kernels::sumMinMax(values_->data(), values_->size()).min;
+    }
+    return values_->front();
+}
+
+int64_t Snapshot::max() const {
+    if (values_->empty()) {
+        return 0;
+    } else if (!sorted_) {
+        return kernels::sumMinMax(values_->data(), values_->size()).max;
     }
+    return values_->back();
+}
 
-    if (n < 2) {
+double Snapshot::mean() const {
+    if (values_->empty()) {
         return 0;
+    } else if (!ranks_) {
+        return kernels::sumMinMax(values_->data(), values_->size()).sum /
+            static_cast<double>(values_->size());
     }
+    return summarize(std::vector<double>()).mean;
+}
 
-    double variance = varsum / static_cast<double>(n - 1);
-    return ::sqrt(variance);
+double Snapshot::stdev() const {
+    return summarize(std::vector<double>()).stdev;
 }
 
 double Snapshot::valueAt(double quantile) const {
@@ -74,23 +355,90 @@ double Snapshot::valueAt(double quantile) const {
         throw std::invalid_argument("quantile must be in [0, 1]");
     }
 
-    if (values_->empty()) {
+    size_t n = size();
+    if (n == 0) {
         return 0;
     }
 
-    // Uses R-7 (default in R, and also in S), linear interpoloation of the
-    // modes for the order statistics of U[0, 1].
-    double idx = quantile * (values_->size() + 1);
+    ensureSorted();
+    return interpolate(quantile, n, [this](size_t rank) {
+            return static_cast<double>(nth(rank));
+        });
+}
 
-    if (idx < 1) {
-        return (*values_)[0];
-    } else if (idx >= values_->size()) {
-        return values_->back();
+Snapshot::Summary Snapshot::summarize(
+        std::vector<double> const& quantiles) const {
+    for (double quantile : quantiles) {
+        if (quantile < 0.0 || quantile > 1.0) {
+            throw std::invalid_argument("quantile must be in [0, 1]");
+        }
     }
 
-    double x_h = (*values_)[static_cast<int>(idx - 1)];
-    double x_hnext = (*values_)[static_cast<int>(idx)];
-    return x_h + (idx - ::floor(idx)) * (x_hnext - x_h);
+    Summary ret;
+    ret.quantiles.resize(quantiles.size(), 0.0);
+    if (values_->empty()) {
+        return ret;
+    }
+
+    // Wellford's algorithm (numerically stable online variance), weighted
+    // by the number of observations of each value, in the same pass as the
+    // sum and extrema. Unweighted moments come from a vectorized kernel,
+    // also in a single pass. Bucketed snapshots count every event, so the
+    // sums are kept in doubles, which cannot overflow on realistic counts.
+    int64_t n = 0;
+    double sum = 0.0;
+    double varsum = 0.0;
+    double mean = 0.0;
+    int64_t prev = 0;
+    if (!ranks_) {
+        auto moments = kernels::moments(values_->data(), values_->size());
+        n = static_cast<int64_t>(values_->size());
+        ret.min = moments.min;
+        ret.max = moments.max;
+        sum = moments.sum;
+        varsum = moments.varsum;
+    } else {
+        ret.min = values_->front();
+        ret.max = values_->back();
+        for (size_t i = 0; i < values_->size(); ++i) {
+            int64_t value = (*values_)[i];
+            int64_t weight = (*ranks_)[i] - prev;
+            prev = (*ranks_)[i];
+            sum += static_cast<double>(value) * weight;
+            n += weight;
+            double delta = value - mean;
+            mean += delta * weight / n;
+            varsum += weight * delta * (value - mean);
+        }
+    }
+
+    ret.count = static_cast<size_t>(n);
+    ret.mean = sum / n;
+    if (n > 1) {
+        ret.stdev = ::sqrt(varsum / static_cast<double>(n - 1));
+    }
+
+    if (!sorted_ && !quantiles.empty()) {
+        // Select just the ranks that the quantiles interpolate between
+        std::vector<size_t> ranks;
+        for (double quantile : quantiles) {
+            interpolate(quantile, ret.count, [&ranks](size_t rank) {
+                    ranks.push_back(rank);
+                    return 0.0;
+                });
+        }
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        multiSelect(values_->begin(), values_->begin(), values_->end(),
+            ranks.begin(), ranks.end());
+    }
+
+    for (size_t i = 0; i < quantiles.size(); ++i) {
+        ret.quantiles[i] = interpolate(quantiles[i], ret.count,
+            [this](size_t rank) { return static_cast<double>(nth(rank)); });
+    }
+
+    return ret;
 }
 
 } // ccmetrics namespace
@@ -0,0 +1,308 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "snapshot_kernels.h"
+
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+// Kernels are compiled for their target ISA with function attributes and
+// selected at runtime, so the library itself needs no special flags.
+#define CCMETRICS_HAVE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace ccmetrics {
+namespace kernels {
+
+namespace {
+// Folds `values[i, n)` into `acc`
+SumMinMax tail(SumMinMax acc, int64_t const *values, size_t i, size_t n) {
+    for (; i < n; ++i) {
+        acc.sum += values[i];
+        acc.min = std::min(acc.min, values[i]);
+        acc.max = std::max(acc.max, values[i]);
+    }
+    return acc;
+}
+
+// Folds the lanes of vector accumulators into `acc`
+SumMinMax lanes(SumMinMax acc, int64_t const *sum, int64_t const *min,
+        int64_t const *max, int width) {
+    for (int i = 0; i < width; ++i) {
+        acc.sum += sum[i];
+        acc.min = std::min(acc.min, min[i]);
+        acc.max = std::max(acc.max, max[i]);
+    }
+    return acc;
+}
+
+SumMinMax identity() {
+    SumMinMax ret = { 0, INT64_MAX, INT64_MIN };
+    return ret;
+}
+
+Moments momentsIdentity() {
+    Moments ret = { INT64_MAX, INT64_MIN, 0.0, 0.0 };
+    return ret;
+}
+
+// Values spanning less than this are offset from the first value exactly in
+// doubles (below 2^51, see `toDouble`)
+const uint64_t kExactSpan = 1ULL << 51;
+
+// Folds `values[i, n)` into `acc`, whose sums are of offsets from `shift`
+Moments shiftedTail(Moments acc, int64_t const *values, size_t i, size_t n,
+        int64_t shift) {
+    for (; i < n; ++i) {
+        // Wraps when the values span 2^63 or more, and is then discarded
+        double delta = static_cast<double>(static_cast<int64_t>(
+            static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(shift)));
+        acc.min = std::min(acc.min, values[i]);
+        acc.max = std::max(acc.max, values[i]);
+        acc.sum += delta;
+        acc.varsum += delta * delta;
+    }
+    return acc;
+}
+
+// Folds the lanes of vector accumulators into `acc`
+Moments shiftedLanes(Moments acc, int64_t const *min, int64_t const *max,
+        double const *sum, double const *sumsq, int width) {
+    for (int i = 0; i < width; ++i) {
+        acc.min = std::min(acc.min, min[i]);
+        acc.max = std::max(acc.max, max[i]);
+        acc.sum += sum[i];
+        acc.varsum += sumsq[i];
+    }
+    return acc;
+}
+
+// Turns sums of offsets from `shift` and of their squares into the sum and
+// the sum of squared deviations, or recomputes both in scalar when the
+// offsets were not exact
+Moments unshift(Moments acc, int64_t const *values, size_t n,
+        int64_t shift) {
+    if (static_cast<uint64_t>(acc.max) - static_cast<uint64_t>(acc.min) >=
+            kExactSpan) {
+        return momentsScalar(values, n);
+    }
+    double count = static_cast<double>(n);
+    Moments ret = acc;
+    ret.sum = static_cast<double>(shift) * count + acc.sum;
+    ret.varsum = std::max(0.0, acc.varsum - acc.sum * acc.sum / count);
+    return ret;
+}
+
+#if defined(CCMETRICS_HAVE_X86_DISPATCH)
+// Bits of the double 2^52 + 2^51. Adding an integer below 2^51 in magnitude
+// to them gives the bits of that double plus the integer, exactly.
+const int64_t kMagic = 0x4338000000000000LL;
+
+__attribute__((target("avx2")))
+SumMinMax sumMinMaxAvx2(int64_t const *values, size_t n) {
+    __m256i sum = _mm256_setzero_si256();
+    __m256i min = _mm256_set1_epi64x(INT64_MAX);
+    __m256i max = _mm256_set1_epi64x(INT64_MIN);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(values + i));
+        sum = _mm256_add_epi64(sum, x);
+        min = _mm256_blendv_epi8(min, x, _mm256_cmpgt_epi64(min, x));
+        max = _mm256_blendv_epi8(max, x, _mm256_cmpgt_epi64(x, max));
+    }
+
+    alignas(32) int64_t s[4], lo[4], hi[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(s), sum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lo), min);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hi), max);
+    return tail(lanes(identity(), s, lo, hi, 4), values, i, n);
+}
+
+__attribute__((target("sse4.2")))
+SumMinMax sumMinMaxSse42(int64_t const *values, size_t n) {
+    __m128i sum = _mm_setzero_si128();
+    __m128i min = _mm_set1_epi64x(INT64_MAX);
+    __m128i max = _mm_set1_epi64x(INT64_MIN);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(values + i));
+        sum = _mm_add_epi64(sum, x);
+        min = _mm_blendv_epi8(min, x, _mm_cmpgt_epi64(min, x));
+        max = _mm_blendv_epi8(max, x, _mm_cmpgt_epi64(x, max));
+    }
+
+    alignas(16) int64_t s[2], lo[2], hi[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(s), sum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lo), min);
+    _mm_store_si128(reinterpret_cast<__m128i*>(hi), max);
+    return tail(lanes(identity(), s, lo, hi, 2), values, i, n);
+}
+
+__attribute__((target("avx2")))
+Moments momentsAvx2(int64_t const *values, size_t n) {
+    if (n == 0) {
+        return momentsIdentity();
+    }
+    const int64_t shift = values[0];
+    const __m256i offset = _mm256_set1_epi64x(shift);
+    const __m256i magic = _mm256_set1_epi64x(kMagic);
+    const __m256d fmagic = _mm256_castsi256_pd(magic);
+    __m256i min = _mm256_set1_epi64x(INT64_MAX);
+    __m256i max = _mm256_set1_epi64x(INT64_MIN);
+    __m256d sum = _mm256_setzero_pd();
+    __m256d sumsq = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(values + i));
+        min = _mm256_blendv_epi8(min, x, _mm256_cmpgt_epi64(min, x));
+        max = _mm256_blendv_epi8(max, x, _mm256_cmpgt_epi64(x, max));
+        __m256d delta = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(
+            _mm256_sub_epi64(x, offset), magic)), fmagic);
+        sum = _mm256_add_pd(sum, delta);
+        sumsq = _mm256_add_pd(sumsq, _mm256_mul_pd(delta, delta));
+    }
+
+    alignas(32) int64_t lo[4], hi[4];
+    alignas(32) double s[4], sq[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lo), min);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hi), max);
+    _mm256_store_pd(s, sum);
+    _mm256_store_pd(sq, sumsq);
+    auto acc = shiftedLanes(momentsIdentity(), lo, hi, s, sq, 4);
+    return unshift(shiftedTail(acc, values, i, n, shift), values, n, shift);
+}
+
+__attribute__((target("sse4.2")))
+Moments momentsSse42(int64_t const *values, size_t n) {
+    if (n == 0) {
+        return momentsIdentity();
+    }
+    const int64_t shift = values[0];
+    const __m128i offset = _mm_set1_epi64x(shift);
+    const __m128i magic = _mm_set1_epi64x(kMagic);
+    const __m128d fmagic = _mm_castsi128_pd(magic);
+    __m128i min = _mm_set1_epi64x(INT64_MAX);
+    __m128i max = _mm_set1_epi64x(INT64_MIN);
+    __m128d sum = _mm_setzero_pd();
+    __m128d sumsq = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(values + i));
+        min = _mm_blendv_epi8(min, x, _mm_cmpgt_epi64(min, x));
+        max = _mm_blendv_epi8(max, x, _mm_cmpgt_epi64(x, max));
+        __m128d delta = _mm_sub_pd(_mm_castsi128_pd(_mm_add_epi64(
+            _mm_sub_epi64(x, offset), magic)), fmagic);
+        sum = _mm_add_pd(sum, delta);
+        sumsq = _mm_add_pd(sumsq, _mm_mul_pd(delta, delta));
+    }
+
+    alignas(16) int64_t lo[2], hi[2];
+    alignas(16) double s[2], sq[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lo), min);
+    _mm_store_si128(reinterpret_cast<__m128i*>(hi), max);
+    _mm_store_pd(s, sum);
+    _mm_store_pd(sq, sumsq);
+    auto acc = shiftedLanes(momentsIdentity(), lo, hi, s, sq, 2);
+    return unshift(shiftedTail(acc, values, i, n, shift), values, n, shift);
+}
+#endif
+
+#if defined(CCMETRICS_HAVE_X86_DISPATCH)
+typedef SumMinMax (*SumMinMaxFn)(int64_t const*, size_t);
+typedef Moments (*MomentsFn)(int64_t const*, size_t);
+
+struct Dispatch {
+    SumMinMaxFn fn;
+    MomentsFn moments;
+    char const *isa;
+};
+
+Dispatch resolve() {
+    // May run before other static constructors
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Dispatch{&sumMinMaxAvx2, &momentsAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Dispatch{&sumMinMaxSse42, &momentsSse42, "sse4.2"};
+    }
+    return Dispatch{&sumMinMaxScalar, &momentsScalar, "scalar"};
+}
+
+// Resolved on first use, so that snapshots taken during static
+// initialization are safe
+Dispatch const& dispatch() {
+    static const Dispatch kDispatch = resolve();
+    return kDispatch;
+}
+#endif
+} // unnamed namespace
+
+SumMinMax sumMinMaxScalar(int64_t const *values, size_t n) {
+    return tail(identity(), values, 0, n);
+}
+
+SumMinMax sumMinMax(int64_t const *values, size_t n) {
+#if defined(CCMETRICS_HAVE_X86_DISPATCH)
+    return dispatch().fn(values, n);
+#else
+    return sumMinMaxScalar(values, n);
+#endif
+}
+
+Moments momentsScalar(int64_t const *values, size_t n) {
+    Moments ret = momentsIdentity();
+    double mean = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t value = values[i];
+        ret.min = std::min(ret.min, value);
+        ret.max = std::max(ret.max, value);
+        ret.sum += static_cast<double>(value);
+        double delta = value - mean;
+        mean += delta / static_cast<double>(i + 1);
+        ret.varsum += delta * (value - mean);
+    }
+    return ret;
+}
+
+Moments moments(int64_t const *values, size_t n) {
+#if defined(CCMETRICS_HAVE_X86_DISPATCH)
+    return dispatch().moments(values, n);
+#else
+    return momentsScalar(values, n);
+#endif
+}
+
+char const* sumMinMaxIsa() {
+#if defined(CCMETRICS_HAVE_X86_DISPATCH)
+    return dispatch().isa;
+#else
+    return "scalar";
+#endif
+}
+
+} // kernels namespace
+} // ccmetrics namespace
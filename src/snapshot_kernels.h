@@ -0,0 +1,82 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SRC_SNAPSHOT_KERNELS_H_
+#define SRC_SNAPSHOT_KERNELS_H_
+
+#include <cinttypes>
+#include <cstddef>
+
+namespace ccmetrics {
+namespace kernels {
+
+/** Sum, minimum and maximum of a run of values. */
+struct SumMinMax {
+    int64_t sum;
+    int64_t min;
+    int64_t max;
+};
+
+/**
+ * @return the sum, minimum and maximum of `values[0, n)`; for `n == 0`,
+ * a zero sum and the identities INT64_MAX and INT64_MIN.
+ *
+ * Uses AVX2 or SSE4.2 (the first with 64-bit compares) where the CPU
+ * supports them, as detected once at startup. Other compilers and
+ * architectures use the scalar implementation.
+ */
+SumMinMax sumMinMax(int64_t const *values, size_t n);
+
+/** The scalar implementation of `sumMinMax`, for testing and comparison. */
+SumMinMax sumMinMaxScalar(int64_t const *values, size_t n);
+
+/** Extrema and moments of a run of values. */
+struct Moments {
+    int64_t min;
+    int64_t max;
+    double sum;
+    /** The sum of squared deviations from the mean. */
+    double varsum;
+};
+
+/**
+ * @return the minimum, maximum, sum and sum of squared deviations of
+ * `values[0, n)` in a single pass; for `n == 0`, zero sums and the
+ * identities INT64_MAX and INT64_MIN.
+ *
+ * Vector implementations sum squares of the values' offsets from the first
+ * value, converted to doubles exactly, and fall back to the scalar
+ * implementation when the values span 2^51 or more.
+ */
+Moments moments(int64_t const *values, size_t n);
+
+/**
+ * The scalar implementation of `moments`, using Welford's algorithm, for
+ * testing and comparison.
+ */
+Moments momentsScalar(int64_t const *values, size_t n);
+
+/** @return the instruction set used by the kernels, e.g. "avx2". */
+char const* sumMinMaxIsa();
+
+} // kernels namespace
+} // ccmetrics namespace
+
+#endif // SRC_SNAPSHOT_KERNELS_H_
@@ -21,18 +21,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <thread>
 #include <vector>
 
+#include "ccmetrics/cycle_clock.h"
+#include "ccmetrics/meter.h"
+#include "ccmetrics/timer.h"
+#include "metrics/per_cpu_int64.h"
 #include "metrics/striped_int64.h"
+#include "metrics/thread_local_int64.h"
+#include "snapshot_kernels.h"
 
 struct AtomicWrapper {
     std::atomic<int64_t> val;
     void add(int64_t delta) { val += delta; }
 };
 
+// Timer updates with a full reservoir; dominated by eviction once more than
+// the reservoir size of updates have been recorded.
+struct TimerWrapper {
+    ccmetrics::Timer timer;
+    void add(int64_t delta) { timer.update(delta); }
+};
+
+struct MeterWrapper {
+    ccmetrics::Meter meter;
+    void add(int64_t delta) { meter.mark(static_cast<int>(delta)); }
+};
+
 template<typename T>
 std::chrono::milliseconds run(T &val, const int K, const int N) {
     auto start = std::chrono::system_clock::now();
@@ -56,6 +75,52 @@ std::chrono::milliseconds run(T &val, const int K, const int N) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 }
 
+// @return nanoseconds per value for `reps` passes of `kernel` over `values`
+template<typename Kernel>
+double kernelNsPerValue(Kernel kernel, std::vector<int64_t> const& values,
+        const int reps) {
+    double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i) {
+        auto ret = kernel(values.data(), values.size());
+        sink += static_cast<double>(ret.sum) + ret.min + ret.max;
+    }
+    auto end = std::chrono::steady_clock::now();
+    // Keep the results live
+    if (sink == 42) {
+        printf(" ");
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+        (static_cast<double>(reps) * values.size());
+}
+
+// @return nanoseconds per empty span timed by a `start` and `stop` read
+template<typename Start, typename Stop>
+double spanNs(Start start, Stop stop, const int reps) {
+    int64_t sink = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i) {
+        int64_t t = start();
+        sink += stop() - t;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (sink == 42) {
+        printf(" ");
+    }
+    return std::chrono::duration<double, std::nano>(end - begin).count() /
+        reps;
+}
+
+static int64_t steadyNow() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+// @return nanoseconds per operation
+static double nsPerOp(std::chrono::milliseconds elapsed, int iters,
+        int threads) {
+    return elapsed.count() * 1E6 / (static_cast<double>(iters) * threads);
+}
+
 int main(int argc, char **argv) {
     if (argc != 3) {
         fprintf(stderr, "Usage: %s [threads] [iters]\n", argv[0]);
@@ -65,14 +130,70 @@ int main(int argc, char **argv) {
     int threads = atoi(argv[1]);
     int iters = atoi(argv[2]);
 
-    AtomicWrapper aval;
-    auto atomics = run(aval, iters, threads);
+    // Scale from one thread up to `threads` by powers of two
+    std::vector<int> counts;
+    for (int n = 1; n < threads; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(threads);
+
+    if (!ccmetrics::PerCpu64::available()) {
+        printf("rseq unavailable; per-cpu figures use a fixed cell\n");
+    }
+
+    printf("%8s %12s %12s %12s %12s\n", "threads", "atomic", "striped",
+        "per-cpu", "thread-local");
+    for (int n : counts) {
+        AtomicWrapper aval;
+        auto atomics = run(aval, iters, n);
+
+        ccmetrics::Striped64 sval;
+        auto stripes = run(sval, iters, n);
+
+        ccmetrics::PerCpu64 pval;
+        auto percpu = run(pval, iters, n);
+
+        ccmetrics::ThreadLocal64 tval;
+        auto locals = run(tval, iters, n);
 
-    ccmetrics::Striped64 sval;
-    auto stripes = run(sval, iters, threads);
+        printf("%8d %9.2f ns %9.2f ns %9.2f ns %9.2f ns\n", n,
+            nsPerOp(atomics, iters, n), nsPerOp(stripes, iters, n),
+            nsPerOp(percpu, iters, n), nsPerOp(locals, iters, n));
+    }
+
+    printf("\n%8s %12s %12s\n", "threads", "meter", "timer");
+    for (int n : counts) {
+        MeterWrapper mval;
+        auto meters = run(mval, iters, n);
+
+        TimerWrapper tval;
+        auto timers = run(tval, iters, n);
+
+        printf("%8d %9.2f ns %9.2f ns\n", n, nsPerOp(meters, iters, n),
+            nsPerOp(timers, iters, n));
+    }
+
+    printf("\n%8s %12s %12s %12s %12s (%s)\n", "values", "scalar",
+        "dispatched", "moments", "dispatched",
+        ccmetrics::kernels::sumMinMaxIsa());
+    for (size_t n : {1028, 16384}) {
+        std::vector<int64_t> values(n);
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = static_cast<int64_t>((i * 2654435761U) % 100000);
+        }
+        const int reps = std::max(1, iters / 100);
+        printf("%8zu %9.3f ns %9.3f ns %9.3f ns %9.3f ns\n", n,
+            kernelNsPerValue(ccmetrics::kernels::sumMinMaxScalar, values, reps),
+            kernelNsPerValue(ccmetrics::kernels::sumMinMax, values, reps),
+            kernelNsPerValue(ccmetrics::kernels::momentsScalar, values, reps),
+            kernelNsPerValue(ccmetrics::kernels::moments, values, reps));
+    }
 
-    printf("Atomics: %lld ms Stripes: %lld ms\n", atomics.count(),
-           stripes.count());
+    printf("\n%12s %12s (%s)\n", "steady", "cycle",
+        ccmetrics::CycleClock::usesTsc() ? "tsc" : "steady");
+    printf("%9.2f ns %9.2f ns\n", spanNs(steadyNow, steadyNow, iters),
+        spanNs(ccmetrics::CycleClock::start, ccmetrics::CycleClock::stop,
+            iters));
 
     return 0;
 }
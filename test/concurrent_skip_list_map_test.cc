@@ -21,6 +21,7 @@
 #include <exception>
 #include <map>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -170,6 +171,100 @@ TEST(ConcurrentSkipListMapTest, FirstKey) {
     ASSERT_TRUE(map.exists(fk));
 }
 
+TEST(ConcurrentSkipListMapTest, PollFirst) {
+    ConcurrentSkipListMap<int, int> map;
+    ASSERT_FALSE(map.pollFirst());
+
+    const int kSize = 100;
+    for (int i = kSize - 1; i >= 0; --i) {
+        map.insert(i, i * 10);
+    }
+
+    for (int i = 0; i < kSize; ++i) {
+        int key = -1, value = -1;
+        ASSERT_TRUE(map.pollFirst(&key, &value));
+        ASSERT_EQ(i, key);
+        ASSERT_EQ(i * 10, value);
+        ASSERT_FALSE(map.exists(i));
+    }
+
+    ASSERT_FALSE(map.pollFirst());
+    ASSERT_TRUE(map.values().empty());
+
+    // Still usable after being drained
+    ASSERT_TRUE(map.insert(1, 1));
+    ASSERT_EQ(1, map.firstKey());
+}
+
+TEST(ConcurrentSkipListMapTest, ConcurrentPollFirst) {
+    ConcurrentSkipListMap<int, int> map;
+    const int kSize = 10000;
+    const int kThreads = 4;
+
+    for (int i = 0; i < kSize; ++i) {
+        map.insert(i, i);
+    }
+
+    // Every entry is polled exactly once, and each thread sees its own
+    // polls in key order
+    std::vector<std::vector<int>> polled(kThreads);
+    auto work = [&](const int id) -> void {
+            int key;
+            while (map.pollFirst(&key)) {
+                polled[id].push_back(key);
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(std::bind(work, i));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::vector<bool> seen(kSize, false);
+    for (auto const& keys : polled) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            ASSERT_FALSE(seen[keys[i]]);
+            seen[keys[i]] = true;
+            if (i > 0) {
+                ASSERT_LT(keys[i - 1], keys[i]);
+            }
+        }
+    }
+    for (int i = 0; i < kSize; ++i) {
+        ASSERT_TRUE(seen[i]);
+    }
+}
+
+TEST(ConcurrentSkipListMapTest, ConcurrentInsertPollFirstStress) {
+    ConcurrentSkipListMap<int, int> map;
+    const int kSize = 1000;
+
+    // Bounded-size map, as used for reservoir eviction
+    auto work = [&](const int id) -> void {
+            auto random = ThreadLocalRandom::current();
+            for (int i = 0; i < 1E5; ++i) {
+                int key = random.next() % kSize;
+                if (map.insert(key, id) && key % 2 == 0) {
+                    map.pollFirst();
+                }
+            }
+        };
+
+    auto t1 = std::thread(std::bind(work, 1));
+    auto t2 = std::thread(std::bind(work, 2));
+
+    t1.join();
+    t2.join();
+
+    auto entries = map.entries();
+    for (size_t i = 1; i < entries.size(); ++i) {
+        ASSERT_LT(entries[i - 1].first, entries[i].first);
+    }
+}
+
 TEST(ConcurrentSkipListMapTest, Values) {
     ConcurrentSkipListMap<int, int> map;
     ASSERT_TRUE(map.values().empty());
@@ -38,6 +38,19 @@ TEST(MetricRegistryTest, CreateCounters) {
     ASSERT_EQ(2U, counters.size());
 }
 
+TEST(MetricRegistryTest, CreateCountersWithOptions) {
+    MetricRegistry reg;
+    CounterOptions options;
+    options.type = CounterType::THREAD_LOCAL;
+    Counter *c1 = reg.counter("foo", options);
+    c1->inc();
+    ASSERT_EQ(1, c1->value());
+
+    // Existing counters are returned regardless of options
+    ASSERT_EQ(c1, reg.counter("foo"));
+    ASSERT_EQ(c1, reg.counter("foo", options));
+}
+
 TEST(MetricRegistryTest,CreateTimers) {
     MetricRegistry reg;
     Timer *t1 = reg.timer("foo");
@@ -50,5 +63,142 @@ TEST(MetricRegistryTest,CreateTimers) {
     ASSERT_EQ(2U, timers.size());
 }
 
+TEST(MetricRegistryTest, CreateTimersWithOptions) {
+    MetricRegistry reg;
+    TimerOptions options;
+    options.reservoir = ReservoirType::SLIDING_WINDOW;
+    options.window_seconds = 10;
+    Timer *t1 = reg.timer("foo", options);
+    ASSERT_EQ(t1, reg.timer("foo"));
+
+    t1->update(5);
+    ASSERT_EQ(5, t1->snapshot().max());
+}
+
+TEST(MetricRegistryTest, DefaultTimerOptions) {
+    MetricRegistry reg;
+    Timer *before = reg.timer("before");
+
+    TimerOptions options;
+    options.reservoir = ReservoirType::SLIDING_COUNT;
+    options.reservoir_size = 2;
+    reg.setDefaultTimerOptions(options);
+
+    Timer *t1 = reg.timer("foo");
+    for (int i = 1; i <= 3; ++i) {
+        before->update(i);
+        t1->update(i);
+    }
+
+    // Only timers created after the change get the new defaults
+    ASSERT_EQ(2, t1->snapshot().min());
+    ASSERT_EQ(1, before->snapshot().min());
+}
+
+TEST(MetricRegistryTest, MergeTimers) {
+    MetricRegistry reg;
+    reg.timer("api.get")->update(1);
+    reg.timer("api.get")->update(3);
+    reg.timer("api.put")->update(2);
+    reg.timer("db.get")->update(100);
+
+    Snapshot api = reg.mergeTimers("api.");
+    ASSERT_EQ(3U, api.size());
+    ASSERT_EQ(1, api.min());
+    ASSERT_EQ(3, api.max());
+    ASSERT_EQ(2.0, api.median());
+
+    ASSERT_EQ(4U, reg.mergeTimers("").size());
+    ASSERT_EQ(0U, reg.mergeTimers("none").size());
+}
+
+TEST(MetricRegistryTest, CreateMetersWithOptions) {
+    MetricRegistry reg;
+    MeterOptions options;
+    options.tick_seconds = 1;
+    options.rate_windows = { 5, 15 };
+    Meter *m1 = reg.meter("foo", options);
+    ASSERT_EQ(m1, reg.meter("foo"));
+    ASSERT_NE(m1, reg.meter("bar", options));
+    ASSERT_EQ(2U, reg.meters().size());
+}
+
+TEST(MetricRegistryTest, Ticker) {
+    MetricRegistry reg;
+    Meter *meter = reg.meter("foo");
+    reg.startTicker();
+    reg.startTicker(); // No effect when running
+
+    // Metrics created while the ticker runs are picked up too
+    Timer *timer = reg.timer("bar");
+    meter->mark();
+    timer->update(1);
+    ASSERT_EQ(0.0, meter->oneMinuteRate());
+
+    reg.stopTicker();
+    reg.stopTicker(); // No effect when stopped
+    reg.startTicker(); // Restartable; the destructor stops it
+}
+
+TEST(MetricRegistryTest, CreateSums) {
+    MetricRegistry reg;
+    Sum *s1 = reg.sum("foo");
+    Sum *s2 = reg.sum("bar");
+    ASSERT_NE(s1, s2);
+    ASSERT_EQ(s1, reg.sum("foo"));
+
+    auto sums = reg.sums();
+    ASSERT_EQ(2U, sums.size());
+}
+
+TEST(MetricRegistryTest, CreateGauges) {
+    MetricRegistry reg;
+    Gauge *g1 = reg.gauge("foo");
+    Gauge *g2 = reg.gauge("bar", []() { return int64_t(5); });
+    ASSERT_NE(g1, g2);
+    ASSERT_EQ(g1, reg.gauge("foo"));
+
+    // Callbacks only apply on creation
+    ASSERT_EQ(g2, reg.gauge("bar", []() { return int64_t(6); }));
+    ASSERT_EQ(5, g2->value());
+
+    DoubleGauge *g3 = reg.doubleGauge("foo");
+    ASSERT_EQ(g3, reg.doubleGauge("foo"));
+
+    ASSERT_EQ(2U, reg.gauges().size());
+    ASSERT_EQ(1U, reg.doubleGauges().size());
+}
+
+TEST(MetricRegistryTest, CreateWaterMarks) {
+    MetricRegistry reg;
+    MaxGauge *g1 = reg.maxGauge("foo");
+    ASSERT_EQ(g1, reg.maxGauge("foo"));
+    MinGauge *g2 = reg.minGauge("foo");
+    ASSERT_EQ(g2, reg.minGauge("foo"));
+
+    ASSERT_EQ(1U, reg.maxGauges().size());
+    ASSERT_EQ(1U, reg.minGauges().size());
+}
+
+TEST(MetricRegistryTest, ResetWaterMarks) {
+    MetricRegistry reg;
+    MaxGauge *g1 = reg.maxGauge("foo");
+    MinGauge *g2 = reg.minGauge("foo");
+    g1->update(7);
+    g2->update(-3);
+
+    // Reads don't reset
+    ASSERT_EQ(7, g1->value());
+    ASSERT_EQ(7, g1->value());
+    ASSERT_EQ(-3, g2->value());
+
+    reg.resetWaterMarks();
+    ASSERT_EQ(0, g1->value());
+    ASSERT_EQ(0, g2->value());
+
+    g1->update(2);
+    ASSERT_EQ(2, g1->value());
+}
+
 } // test namespace
 } // ccmetrics namespace
@@ -42,5 +42,25 @@ TEST(CounterTest, BasicFunctionality) {
     ASSERT_EQ(1, c1.value());
 }
 
+TEST(CounterTest, ThreadLocal) {
+    CounterOptions options;
+    options.type = CounterType::THREAD_LOCAL;
+    Counter c1(options);
+    ASSERT_EQ(0, c1.value());
+
+    c1.inc();
+    c1.update(2);
+    c1.dec();
+    ASSERT_EQ(2, c1.value());
+}
+
+TEST(CounterTest, MaxStripes) {
+    CounterOptions options;
+    options.max_stripes = 2;
+    Counter c1(options);
+    c1.update(3);
+    ASSERT_EQ(3, c1.value());
+}
+
 } // test namespace
 } // ccmetrics namespace
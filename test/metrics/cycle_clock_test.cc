@@ -0,0 +1,63 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "ccmetrics/cycle_clock.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(CycleClockTest, InvariantTsc) {
+    ASSERT_TRUE(CycleClock::invariantTsc(
+        "flags\t\t: fpu tsc constant_tsc rep_good nopl nonstop_tsc cpuid"));
+    ASSERT_FALSE(CycleClock::invariantTsc("flags\t\t: fpu tsc constant_tsc"));
+    ASSERT_FALSE(CycleClock::invariantTsc("flags\t\t: fpu tsc nonstop_tsc"));
+    ASSERT_FALSE(CycleClock::invariantTsc(
+        "flags\t\t: fpu constant_tsc_x nonstop_tsc"));
+    ASSERT_FALSE(CycleClock::invariantTsc(""));
+}
+
+TEST(CycleClockTest, InitIsIdempotent) {
+    CycleClock::init();
+    bool tsc = CycleClock::usesTsc();
+    CycleClock::init();
+    ASSERT_EQ(tsc, CycleClock::usesTsc());
+}
+
+// Whichever source is in use, spans convert to wall time
+TEST(CycleClockTest, Calibrated) {
+    auto steady = std::chrono::steady_clock::now();
+    int64_t start = CycleClock::start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int64_t stop = CycleClock::stop();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - steady).count();
+
+    int64_t us = CycleClock::toMicros(stop - start);
+    ASSERT_GE(us, 19000);
+    ASSERT_LE(us, elapsed + 1000);
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -51,5 +51,29 @@ TEST(ExponentialReservoirTest, Sampling) {
     ASSERT_EQ(1, res.snapshot().max());
 }
 
+TEST(ExponentialReservoirTest, BoundedSize) {
+    ExponentialReservoir res;
+
+    for (int i = 0; i < 1E4; ++i) {
+        res.update(i);
+    }
+
+    Snapshot snap = res.snapshot();
+    ASSERT_GE(1028U, snap.size());
+    ASSERT_LT(1000U, snap.size());
+}
+
+TEST(ExponentialReservoirTest, Configured) {
+    ExponentialReservoir res(10, 0.1);
+
+    for (int i = 0; i < 100; ++i) {
+        res.update(i);
+    }
+    ASSERT_EQ(10U, res.snapshot().size());
+
+    ASSERT_THROW(ExponentialReservoir(0), std::invalid_argument);
+    ASSERT_THROW(ExponentialReservoir(10, -1), std::invalid_argument);
+}
+
 } // test namespace
 } // ccmetrics namespace
@@ -0,0 +1,62 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ccmetrics/gauge.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(GaugeTest, Settable) {
+    Gauge g1;
+    ASSERT_EQ(0, g1.value());
+
+    g1.set(42);
+    ASSERT_EQ(42, g1.value());
+
+    g1.set(-3);
+    ASSERT_EQ(-3, g1.value());
+
+    DoubleGauge g2;
+    ASSERT_EQ(0.0, g2.value());
+
+    g2.set(0.5);
+    ASSERT_EQ(0.5, g2.value());
+}
+
+TEST(GaugeTest, Callback) {
+    int64_t depth = 7;
+    Gauge g1([&depth]() { return depth; });
+    ASSERT_EQ(7, g1.value());
+
+    depth = 9;
+    ASSERT_EQ(9, g1.value());
+
+    // Setting a callback gauge has no effect
+    g1.set(1);
+    ASSERT_EQ(9, g1.value());
+
+    DoubleGauge g2([]() { return 1.25; });
+    ASSERT_EQ(1.25, g2.value());
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -0,0 +1,94 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "metrics/hdr_reservoir.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(HdrReservoirTest, BasicFunctionality) {
+    HdrReservoir res;
+    ASSERT_EQ(0U, res.snapshot().size());
+
+    // Small values are recorded exactly
+    for (int i = 0; i <= 100; ++i) {
+        res.update(i);
+    }
+
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(101U, snap.size());
+    ASSERT_EQ(0, snap.min());
+    ASSERT_EQ(100, snap.max());
+    ASSERT_EQ(50, snap.median());
+    ASSERT_LT(99, snap.get99tile());
+}
+
+TEST(HdrReservoirTest, Precision) {
+    HdrReservoir res(HdrReservoir::kDefaultHighest, 2);
+
+    const int64_t values[] = { 1000, 12345, 999999, 3600LL * 1000 * 1000 };
+    for (int64_t value : values) {
+        HdrReservoir single;
+        single.update(value);
+        // Within two significant digits
+        double recorded = single.snapshot().median();
+        ASSERT_NEAR(value, recorded, value / 100.0);
+    }
+}
+
+TEST(HdrReservoirTest, Clamping) {
+    HdrReservoir res(1000, 2);
+    res.update(-5);
+    res.update(1000000);
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(2U, snap.size());
+    ASSERT_EQ(0, snap.min());
+    ASSERT_NEAR(1000, snap.max(), 10);
+}
+
+// Bucketed snapshots count every event, so moments must not overflow
+TEST(HdrReservoirTest, LargeCounts) {
+    HdrReservoir res;
+    const int64_t kCount = 10 * 1000 * 1000;
+    const int64_t kHigh = 2 * 1000 * 1000;
+    for (int64_t i = 0; i < kCount; ++i) {
+        res.update(i % 2 == 0 ? 0 : kHigh);
+    }
+
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(static_cast<size_t>(kCount), snap.size());
+    double high = snap.max();
+    ASSERT_NEAR(kHigh, high, kHigh / 100.0);
+    ASSERT_NEAR(high / 2, snap.mean(), 1.0);
+    ASSERT_NEAR(high / 2, snap.stdev(), 1.0);
+}
+
+TEST(HdrReservoirTest, InvalidArguments) {
+    ASSERT_THROW(HdrReservoir(1, 2), std::invalid_argument);
+    ASSERT_THROW(HdrReservoir(1000, 0), std::invalid_argument);
+    ASSERT_THROW(HdrReservoir(1000, 6), std::invalid_argument);
+}
+
+} // test namespace
+} // ccmetrics namespace
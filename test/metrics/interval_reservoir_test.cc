@@ -0,0 +1,94 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include "metrics/interval_reservoir.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(IntervalReservoirTest, BasicFunctionality) {
+    IntervalReservoir res;
+    ASSERT_EQ(0U, res.snapshot().size());
+
+    for (int i = 0; i <= 100; ++i) {
+        res.update(i);
+    }
+
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(101U, snap.size());
+    ASSERT_EQ(0, snap.min());
+    ASSERT_EQ(100, snap.max());
+    ASSERT_EQ(50, snap.median());
+
+    // Snapshots cover only their own interval
+    ASSERT_EQ(0U, res.snapshot().size());
+    res.update(7);
+    Snapshot next = res.snapshot();
+    ASSERT_EQ(1U, next.size());
+    ASSERT_EQ(7, next.max());
+}
+
+TEST(IntervalReservoirTest, ExitedThreads) {
+    IntervalReservoir res;
+    std::thread([&res]() { res.update(3); res.update(5); }).join();
+    res.update(1);
+
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(3U, snap.size());
+    ASSERT_EQ(1, snap.min());
+    ASSERT_EQ(5, snap.max());
+}
+
+// Non-deterministic but expected to exercise snapshots concurrent with
+// updates; no value may be lost or counted twice across the intervals
+TEST(IntervalReservoirTest, ConcurrencySmokeTest) {
+    IntervalReservoir res;
+    const int K = 100000;
+    std::atomic<int> done(0);
+
+    auto work = [&res, &done, K]() -> void {
+            for (int i = 0; i < K; ++i) { res.update(i & 0xff); }
+            done.fetch_add(1);
+        };
+
+    std::array<std::thread, 4> workers { std::thread(work), std::thread(work),
+        std::thread(work), std::thread(work) };
+
+    size_t total = 0;
+    while (done.load() < static_cast<int>(workers.size())) {
+        total += res.snapshot().size();
+    }
+
+    for (auto i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    total += res.snapshot().size();
+
+    ASSERT_EQ(K * workers.size(), total);
+}
+
+} // test namespace
+} // ccmetrics namespace
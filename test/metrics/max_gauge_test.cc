@@ -0,0 +1,58 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ccmetrics/max_gauge.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(MaxGaugeTest, BasicFunctionality) {
+    MaxGauge g1;
+    ASSERT_EQ(0, g1.value());
+
+    g1.update(4);
+    g1.update(9);
+    g1.update(2);
+    ASSERT_EQ(9, g1.value());
+
+    // Each interval starts afresh
+    ASSERT_EQ(9, g1.getAndReset());
+    ASSERT_EQ(0, g1.value());
+    g1.update(3);
+    ASSERT_EQ(3, g1.getAndReset());
+}
+
+TEST(MinGaugeTest, BasicFunctionality) {
+    MinGauge g1;
+    ASSERT_EQ(0, g1.value());
+
+    g1.update(4);
+    g1.update(9);
+    g1.update(2);
+    ASSERT_EQ(2, g1.value());
+
+    ASSERT_EQ(2, g1.getAndReset());
+    ASSERT_EQ(0, g1.value());
+}
+
+} // test namespace
+} // ccmetrics namespace
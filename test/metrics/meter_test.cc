@@ -20,32 +20,143 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 #include "metrics/meter_impl.h"
+#include "metrics/tick_clock.h"
 
 namespace ccmetrics {
 namespace test {
 
-class RateEWMATest : public ::testing::Test {
+class MeterImplTest : public ::testing::Test {
 public:
-    void tick(RateEWMA &rate) {
-        rate.tick();
+    int64_t tick(MeterImpl &meter) {
+        return meter.tick();
     }
 };
 
+TEST(RateEWMATest, BasicFunctionality) {
+    RateEWMA rate(5, 60);
+    rate.tick(1); // 5s
+    ASSERT_EQ(1.0 / 5, rate.rate());
+
+    rate.tick(1); // 10s
+    ASSERT_EQ(1.0 / 5, rate.rate());
+
+    rate.tick(0); // 15s
+    ASSERT_LT(rate.rate(), 1.0 / 5);
+}
+
 // Brittle under debuggers or valgrind, fyi. Could use a mock clock.
-TEST_F(RateEWMATest, BasicFunctionality) {
-    RateEWMA rate(MeterImpl::kOneMinuteAlpha);
-    rate.update(1);
-    tick(rate); // Force tick to 5s
-    ASSERT_EQ(1.0 / static_cast<double>(RateEWMA::kInterval), rate.rate());
-
-    rate.update(1);
-    tick(rate); // Force tick to 10s
-    ASSERT_EQ(1.0 / static_cast<double>(RateEWMA::kInterval), rate.rate());
-
-    rate.update(0);
-    tick(rate); // Force tick to 15s
-    ASSERT_LT(rate.rate(), 1.0 / static_cast<double>(RateEWMA::kInterval));
+TEST_F(MeterImplTest, TicksAllRates) {
+    MeterImpl meter;
+    meter.mark();
+    ASSERT_EQ(1, tick(meter)); // Force tick to 5s
+
+    // Every window starts at the first interval's rate
+    const double kRate = 1.0 / 5;
+    ASSERT_EQ(kRate, meter.oneMinuteRate());
+    ASSERT_EQ(kRate, meter.fiveMinuteRate());
+    ASSERT_EQ(kRate, meter.fifteenMinuteRate());
+
+    ASSERT_EQ(0, tick(meter)); // Force tick to 10s
+
+    // ... and decays at its own pace
+    ASSERT_LT(meter.oneMinuteRate(), meter.fiveMinuteRate());
+    ASSERT_LT(meter.fiveMinuteRate(), meter.fifteenMinuteRate());
+    ASSERT_LT(meter.fifteenMinuteRate(), kRate);
+}
+
+TEST_F(MeterImplTest, ExternalTicking) {
+    MeterImpl meter;
+    meter.setTickedExternally(true);
+    meter.mark(5);
+    ASSERT_EQ(0.0, meter.oneMinuteRate());
+
+    // Nothing to do until an interval has passed
+    auto now = TickClock::now();
+    ASSERT_EQ(0, meter.tickExternally(now));
+    ASSERT_EQ(5, meter.tickExternally(now + std::chrono::seconds(5)));
+    ASSERT_EQ(1.0, meter.oneMinuteRate());
+
+    // Lazy ticking resumes a full interval from the switch
+    meter.setTickedExternally(false);
+    meter.mark();
+    ASSERT_EQ(1.0, meter.oneMinuteRate());
+}
+
+TEST_F(MeterImplTest, ConfiguredWindows) {
+    MeterOptions options;
+    options.tick_seconds = 1;
+    options.rate_windows = { 5, 15 };
+    MeterImpl meter(options);
+    meter.setTickedExternally(true);
+    ASSERT_EQ((std::vector<int>{ 5, 15 }), meter.rateWindows());
+
+    meter.mark(10);
+    auto now = TickClock::now() + std::chrono::seconds(1);
+    ASSERT_EQ(10, meter.tickExternally(now));
+    ASSERT_EQ(10.0, meter.rate(5));
+    ASSERT_EQ(10.0, meter.rate(15));
+
+    // Untracked windows read as zero
+    ASSERT_EQ(0.0, meter.oneMinuteRate());
+    ASSERT_EQ(0.0, meter.rate(60));
+
+    // A quiet second decays the short window faster
+    ASSERT_EQ(0, meter.tickExternally(now + std::chrono::seconds(1)));
+    ASSERT_LT(meter.rate(5), meter.rate(15));
+    ASSERT_LT(meter.rate(15), 10.0);
+
+    // Missed intervals decay too
+    double rate = meter.rate(5);
+    meter.tickExternally(now + std::chrono::seconds(5));
+    ASSERT_LT(meter.rate(5), rate / 2);
+}
+
+TEST_F(MeterImplTest, InvalidOptions) {
+    MeterOptions options;
+    options.tick_seconds = 0;
+    ASSERT_THROW(MeterImpl meter(options), std::invalid_argument);
+
+    options.tick_seconds = 1;
+    options.rate_windows = { 60, 0 };
+    ASSERT_THROW(MeterImpl meter(options), std::invalid_argument);
+}
+
+// Ticks concurrent with updates must account for every event. Like the
+// above, brittle if the updates take longer than a tick interval.
+TEST_F(MeterImplTest, TickIsLossless) {
+    MeterImpl meter;
+    const int K = 100000;
+    const int N = 4;
+
+    std::atomic<int> running(N);
+    auto work = [&]() -> void {
+            for (int i = 0; i < K; ++i) { meter.mark(); }
+            --running;
+        };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < N; ++i) {
+        workers.emplace_back(work);
+    }
+
+    int64_t ticked = 0;
+    while (running > 0) {
+        ticked += tick(meter);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    ticked += tick(meter);
+    ASSERT_EQ(K * N, ticked);
 }
 
 } // test namespace
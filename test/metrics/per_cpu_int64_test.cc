@@ -0,0 +1,74 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+#include "ccmetrics/counter.h"
+#include "metrics/per_cpu_int64.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(PerCpu64Test, BasicFunctionality) {
+    PerCpu64 val;
+    ASSERT_EQ(0, val.value());
+
+    val.add(1);
+    ASSERT_EQ(1, val.value());
+
+    val.add(-1);
+    ASSERT_EQ(0, val.value());
+}
+
+// Non-deterministic but expected to exercise concurrent updates
+TEST(PerCpu64Test, ConcurrencySmokeTest) {
+    PerCpu64 val;
+    const int K = 100000;   // 100000 updates per
+    const int N = 4;        // 4-way workers
+
+    auto work = [&]() -> void {
+            for (int i = 0; i < K; ++i) { val.add(1); }
+        };
+
+    std::array<std::thread, N> workers { std::thread(work), std::thread(work),
+        std::thread(work), std::thread(work) };
+
+    for (auto i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    ASSERT_EQ(K * N, val.value());
+}
+
+// Per-CPU counters work whether or not rseq is available
+TEST(PerCpu64Test, CounterFallback) {
+    CounterOptions options;
+    options.type = CounterType::PER_CPU;
+    Counter c1(options);
+    c1.inc();
+    c1.update(2);
+    ASSERT_EQ(3, c1.value());
+}
+
+} // test namespace
+} // ccmetrics namespace
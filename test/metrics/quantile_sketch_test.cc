@@ -0,0 +1,218 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "ccmetrics/quantile_sketch.h"
+#include "ccmetrics/timer.h"
+#include "metrics/sketch_reservoir.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(QuantileSketchTest, BasicFunctionality) {
+    QuantileSketch sketch;
+    ASSERT_EQ(0, sketch.count());
+    ASSERT_EQ(0.0, sketch.snapshot().median());
+
+    for (int i = 1; i <= 1000; ++i) {
+        sketch.update(i);
+    }
+    ASSERT_EQ(1000, sketch.count());
+
+    Snapshot snap = sketch.snapshot();
+    ASSERT_EQ(1000U, snap.size());
+    ASSERT_NEAR(500, snap.median(), 500 * 0.01 + 1);
+    ASSERT_NEAR(990, snap.get99tile(), 990 * 0.01 + 1);
+    ASSERT_NEAR(1000, snap.max(), 1000 * 0.01);
+    ASSERT_EQ(1, snap.min());
+}
+
+TEST(QuantileSketchTest, NegativeAndZero) {
+    QuantileSketch sketch;
+    sketch.update(-100);
+    sketch.update(0, 2);
+    sketch.update(INT64_MIN);
+    sketch.update(100);
+
+    Snapshot snap = sketch.snapshot();
+    ASSERT_EQ(5U, snap.size());
+    ASSERT_EQ(0.0, snap.median());
+    ASSERT_NEAR(50, snap.get75tile(), 1);
+    ASSERT_GT(0, snap.min());
+    ASSERT_NEAR(100, snap.max(), 1);
+}
+
+TEST(QuantileSketchTest, Merge) {
+    // Shards with disjoint halves of the values
+    QuantileSketch low;
+    QuantileSketch high;
+    QuantileSketch all;
+    for (int i = 1; i <= 1000; ++i) {
+        (i <= 500 ? low : high).update(i);
+        all.update(i);
+    }
+
+    low.merge(high);
+    ASSERT_EQ(all.count(), low.count());
+    ASSERT_EQ(all.encode(), low.encode());
+    ASSERT_EQ(all.snapshot().get99tile(), low.snapshot().get99tile());
+
+    QuantileSketch other(0.05);
+    ASSERT_THROW(low.merge(other), std::invalid_argument);
+}
+
+TEST(QuantileSketchTest, Encoding) {
+    QuantileSketch sketch(0.02);
+    for (int i = 0; i < 1000; ++i) {
+        sketch.update(i * 37 - 500);
+    }
+
+    std::string bytes = sketch.encode();
+    QuantileSketch decoded = QuantileSketch::decode(bytes);
+    ASSERT_EQ(0.02, decoded.accuracy());
+    ASSERT_EQ(sketch.count(), decoded.count());
+    ASSERT_EQ(bytes, decoded.encode());
+    ASSERT_EQ(sketch.snapshot().median(), decoded.snapshot().median());
+
+    ASSERT_THROW(QuantileSketch::decode(""), std::invalid_argument);
+    ASSERT_THROW(QuantileSketch::decode(bytes.substr(0, bytes.size() - 1)),
+        std::invalid_argument);
+    ASSERT_THROW(QuantileSketch::decode(bytes + "x"), std::invalid_argument);
+}
+
+TEST(QuantileSketchTest, Accuracy) {
+    ASSERT_THROW(QuantileSketch(0.0), std::invalid_argument);
+    ASSERT_THROW(QuantileSketch(1.0), std::invalid_argument);
+    ASSERT_THROW(QuantileSketch(1E-17), std::invalid_argument);
+    ASSERT_THROW(QuantileSketch(QuantileSketch::kMinAccuracy / 2),
+        std::invalid_argument);
+
+    QuantileSketch sketch(QuantileSketch::kMinAccuracy);
+    sketch.update(5);
+    sketch.update(1000000);
+    ASSERT_EQ(5, sketch.snapshot().min());
+    ASSERT_NEAR(1000000, sketch.snapshot().max(), 1);
+}
+
+namespace {
+// Header for an encoding at `accuracy`
+std::string encodingHeader(double accuracy) {
+    std::string ret(1, '\x01');
+    uint64_t bits;
+    memcpy(&bits, &accuracy, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        ret.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+    return ret;
+}
+} // unnamed namespace
+
+// Buckets below the lowest non-empty one take no space, so a sketch (or
+// encoding) of only huge values at the finest accuracy stays small
+TEST(QuantileSketchTest, SparseLowBuckets) {
+    std::string bytes = encodingHeader(QuantileSketch::kMinAccuracy);
+    bytes.push_back(0);        // zero count
+    bytes += "\x80\xe3\xbe\x0a"; // first positive bucket, 22,000,000
+    bytes.push_back(0);        // ... and no counts
+    bytes.push_back(0);        // no negative buckets
+    bytes.push_back(0);
+    QuantileSketch decoded = QuantileSketch::decode(bytes);
+    ASSERT_EQ(0, decoded.count());
+
+    QuantileSketch sketch(QuantileSketch::kMinAccuracy);
+    sketch.update(-1000000000000LL);
+    sketch.update(1000000000000LL);
+    sketch.update(1000000000001LL, 2);
+    ASSERT_LT(sketch.encode().size(), 100U);
+
+    // Merging extends the span on either side
+    QuantileSketch other(QuantileSketch::kMinAccuracy);
+    other.update(1000100000000LL);
+    other.merge(sketch);
+    other.update(999900000000LL);
+    ASSERT_EQ(6, other.count());
+    Snapshot snap = other.snapshot();
+    ASSERT_NEAR(-1E12, snap.min(), 1E7);
+    ASSERT_NEAR(1E12, snap.median(), 1E7);
+    ASSERT_NEAR(1.0001E12, snap.max(), 1E7);
+
+    QuantileSketch decoded2 = QuantileSketch::decode(other.encode());
+    ASSERT_EQ(other.encode(), decoded2.encode());
+}
+
+TEST(QuantileSketchTest, DecodeTruncated) {
+    QuantileSketch sketch;
+    sketch.update(7);
+    std::string bytes = sketch.encode();
+    for (size_t n = 0; n < bytes.size(); ++n) {
+        ASSERT_THROW(QuantileSketch::decode(bytes.substr(0, n)),
+            std::invalid_argument);
+    }
+}
+
+TEST(QuantileSketchTest, DecodeAdversarial) {
+    // Accuracies the constructor rejects are rejected on decode
+    ASSERT_THROW(QuantileSketch::decode(
+        encodingHeader(1E-9) + std::string(7, '\0')), std::invalid_argument);
+    ASSERT_THROW(QuantileSketch::decode(
+        encodingHeader(std::nan("")) + std::string(3, '\0')),
+        std::invalid_argument);
+
+    // A huge bucket range with no counts behind it fails before allocating
+    std::string bytes = encodingHeader(QuantileSketch::kMinAccuracy);
+    bytes.push_back(0);    // zero count
+    bytes.push_back(0);    // first positive bucket
+    bytes += "\xff\xff\x7f"; // about 2M positive buckets
+    ASSERT_THROW(QuantileSketch::decode(bytes), std::invalid_argument);
+    bytes.push_back(1);    // ... of which one is present
+    ASSERT_THROW(QuantileSketch::decode(bytes), std::invalid_argument);
+}
+
+TEST(QuantileSketchTest, Reservoir) {
+    SketchReservoir res;
+    QuantileSketch expected;
+    for (int i = -10; i <= 1000; ++i) {
+        res.update(i);
+        expected.update(i);
+    }
+    ASSERT_EQ(expected.encode(), res.sketch().encode());
+    ASSERT_EQ(expected.snapshot().median(), res.snapshot().median());
+}
+
+TEST(QuantileSketchTest, Timer) {
+    TimerOptions options;
+    options.reservoir = ReservoirType::SKETCH;
+    Timer t1(options);
+    t1.update(10);
+    ASSERT_EQ(1, t1.sketch().count());
+
+    Timer t2;
+    ASSERT_THROW(t2.sketch(), std::logic_error);
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -0,0 +1,55 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "metrics/sliding_count_reservoir.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(SlidingCountReservoirTest, BasicFunctionality) {
+    SlidingCountReservoir res(3);
+    ASSERT_EQ(0U, res.snapshot().size());
+
+    res.update(5);
+    res.update(1);
+    Snapshot partial = res.snapshot();
+    ASSERT_EQ(2U, partial.size());
+    ASSERT_EQ(1, partial.min());
+    ASSERT_EQ(5, partial.max());
+
+    // Only the last three values are kept
+    res.update(2);
+    res.update(3);
+    Snapshot full = res.snapshot();
+    ASSERT_EQ(3U, full.size());
+    ASSERT_EQ(1, full.min());
+    ASSERT_EQ(3, full.max());
+}
+
+TEST(SlidingCountReservoirTest, InvalidArguments) {
+    ASSERT_THROW(SlidingCountReservoir(0), std::invalid_argument);
+}
+
+} // test namespace
+} // ccmetrics namespace
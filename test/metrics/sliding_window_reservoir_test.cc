@@ -0,0 +1,86 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "metrics/sliding_window_reservoir.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(SlidingWindowReservoirTest, BasicFunctionality) {
+    SlidingWindowReservoir res;
+    ASSERT_EQ(60, res.window());
+    ASSERT_EQ(0U, res.snapshot().size());
+
+    for (int i = 0; i <= 100; ++i) {
+        res.update(i);
+    }
+
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(101U, snap.size());
+    ASSERT_EQ(0, snap.min());
+    ASSERT_EQ(100, snap.max());
+    ASSERT_EQ(50, snap.median());
+}
+
+TEST(SlidingWindowReservoirTest, ValuesAgeOut) {
+    SlidingWindowReservoir res(3);
+    res.updateAt(100, 0);
+    res.updateAt(1, 1);
+    res.updateAt(2, 2);
+
+    Snapshot all = res.snapshotAt(2);
+    ASSERT_EQ(3U, all.size());
+    ASSERT_EQ(100, all.max());
+
+    // Second 0 has left the window, and its slot is recycled for second 3
+    Snapshot aged = res.snapshotAt(3);
+    ASSERT_EQ(2U, aged.size());
+    ASSERT_EQ(2, aged.max());
+    res.updateAt(3, 3);
+    Snapshot recycled = res.snapshotAt(3);
+    ASSERT_EQ(3U, recycled.size());
+    ASSERT_EQ(3, recycled.max());
+
+    // Gaps longer than the window leave nothing live
+    ASSERT_EQ(0U, res.snapshotAt(100).size());
+    res.updateAt(5, 100);
+    ASSERT_EQ(1U, res.snapshotAt(100).size());
+}
+
+TEST(SlidingWindowReservoirTest, StaleUpdatesDropped) {
+    SlidingWindowReservoir res(2);
+    res.updateAt(1, 4);
+    // Second 2 maps to the same slot as second 4
+    res.updateAt(2, 2);
+    Snapshot snap = res.snapshotAt(4);
+    ASSERT_EQ(1U, snap.size());
+    ASSERT_EQ(1, snap.max());
+}
+
+TEST(SlidingWindowReservoirTest, InvalidArguments) {
+    ASSERT_THROW(SlidingWindowReservoir(0), std::invalid_argument);
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -0,0 +1,79 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+#include "metrics/striped_double.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(StripedDoubleTest, BasicFunctionality) {
+    StripedDouble val;
+    ASSERT_EQ(0.0, val.value());
+    val.add(1.5);
+    ASSERT_EQ(1.5, val.value());
+    val.add(-0.25);
+    ASSERT_EQ(1.25, val.value());
+
+    // Pre-expanded to 4 stripes; the value is the same
+    StripedDouble val2(4);
+    ASSERT_EQ(4U, val2.stripes());
+    val2.add(0.5);
+    val2.add(0.5);
+    ASSERT_EQ(1.0, val2.value());
+}
+
+TEST(StripedDoubleTest, Reset) {
+    StripedDouble val(4);
+    val.add(2.5);
+    ASSERT_EQ(2.5, val.sumThenReset());
+    ASSERT_EQ(0.0, val.value());
+    val.add(1.0);
+    val.reset();
+    ASSERT_EQ(0.0, val.value());
+}
+
+// Non-deterministic but expected to exercise concurrent updates. The
+// increments are exactly representable, so the sum is exact.
+TEST(StripedDoubleTest, ConcurrencySmokeTest) {
+    StripedDouble val;
+    const int K = 100000;
+
+    auto work = [&val]() -> void {
+            for (int i = 0; i < K; ++i) { val.add(0.5); }
+        };
+
+    std::array<std::thread, 4> workers { std::thread(work), std::thread(work),
+        std::thread(work), std::thread(work) };
+
+    for (auto i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    ASSERT_EQ(0.5 * K * workers.size(), val.value());
+    ASSERT_LE(val.stripes(), val.maxStripes());
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -0,0 +1,82 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+#include "metrics/striped_extremum.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(StripedExtremumTest, Max) {
+    StripedMax val;
+    ASSERT_EQ(StripedMax::kIdentity, val.value());
+    val.update(3);
+    val.update(-7);
+    ASSERT_EQ(3, val.value());
+
+    // Pre-expanded to 4 stripes; the value is the same
+    StripedMax val2(4);
+    ASSERT_EQ(4U, val2.stripes());
+    val2.update(5);
+    val2.update(2);
+    ASSERT_EQ(5, val2.value());
+    ASSERT_EQ(5, val2.getAndReset());
+    ASSERT_EQ(StripedMax::kIdentity, val2.value());
+}
+
+TEST(StripedExtremumTest, Min) {
+    StripedMin val(4);
+    ASSERT_EQ(StripedMin::kIdentity, val.value());
+    val.update(3);
+    val.update(-7);
+    ASSERT_EQ(-7, val.value());
+    ASSERT_EQ(-7, val.getAndReset());
+    val.update(1);
+    ASSERT_EQ(1, val.value());
+    val.reset();
+    ASSERT_EQ(StripedMin::kIdentity, val.value());
+}
+
+// Non-deterministic but expected to exercise concurrent updates
+TEST(StripedExtremumTest, ConcurrencySmokeTest) {
+    StripedMax val;
+    const int K = 100000;
+
+    auto work = [&val, K](int offset) -> void {
+            for (int i = 0; i < K; ++i) { val.update(i + offset); }
+        };
+
+    std::array<std::thread, 4> workers { std::thread(work, 0),
+        std::thread(work, 1), std::thread(work, 2), std::thread(work, 3) };
+
+    for (auto i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    ASSERT_EQ(K - 1 + 3, val.value());
+    ASSERT_LE(val.stripes(), val.maxStripes());
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <thread>
 
 #include "metrics/striped_int64.h"
@@ -32,19 +33,24 @@ namespace test {
 TEST(Striped64_StorageTest, BasicFuncationality) {
     Striped64_Storage s1;
     ASSERT_EQ(2U, s1.size());
+    ASSERT_EQ(nullptr, s1.previous());
 
     Striped64_Storage* s2 = Striped64_Storage::expand(&s1);
     EXPECT_EQ(4U, s2->size());
-    s2->disavow();
+    EXPECT_EQ(&s1, s2->previous());
     delete s2;
 
     Striped64_Storage* s3 = Striped64_Storage::expand(&s1);
     EXPECT_EQ(4U, s3->size());
 
-    // Failure to disavow s1 will lead to double free
-    s1.disavow_all();
+    // Expanded storage shares the existing elements
+    s1.get(1).store(7);
+    EXPECT_EQ(7, s3->get(1).load());
+    EXPECT_EQ(0, s3->get(3).load());
 
+    // Deleting an expanded array leaves the original's elements intact
     delete s3;
+    EXPECT_EQ(7, s1.get(1).load());
 }
 
 TEST(Striped64Test, BasicFunctionality) {
@@ -73,9 +79,77 @@ TEST(Striped64Test, Reset) {
     ASSERT_EQ(0, val.value());
 }
 
+TEST(Striped64Test, MaxStripes) {
+    // The default scales with the hardware, but is never less than 2
+    size_t hardware = Striped64::defaultMaxStripes();
+    ASSERT_LE(2U, hardware);
+    ASSERT_EQ(0U, hardware & (hardware - 1));
+    ASSERT_LE(std::thread::hardware_concurrency(), hardware);
+
+    Striped64 val;
+    ASSERT_EQ(hardware, val.maxStripes());
+    val.setMaxStripes(5);
+    ASSERT_EQ(8U, val.maxStripes());
+
+    Striped64::setDefaultMaxStripes(3);
+    ASSERT_EQ(4U, Striped64::defaultMaxStripes());
+    ASSERT_EQ(8U, val.maxStripes());
+    val.setMaxStripes(0);
+    ASSERT_EQ(4U, val.maxStripes());
+
+    Striped64::setDefaultMaxStripes(0);
+    ASSERT_EQ(hardware, Striped64::defaultMaxStripes());
+}
+
+TEST(Striped64Test, UncontendedUsesBase) {
+    Striped64 val;
+    for (int i = 0; i < 1000; ++i) {
+        val.add(1);
+    }
+    ASSERT_EQ(1000, val.value());
+    ASSERT_EQ(0U, val.stripes());
+}
+
+TEST(Striped64Test, SumThenReset) {
+    Striped64 val(4);
+    val.add(3);
+    ASSERT_EQ(3, val.sumThenReset());
+    ASSERT_EQ(0, val.value());
+    ASSERT_EQ(0, val.sumThenReset());
+}
+
+// Draining concurrently with updates loses nothing
+TEST(Striped64Test, ConcurrentSumThenReset) {
+    Striped64 val;
+    const int K = 100000;
+    const int N = 4;
+
+    std::atomic<int> running(N);
+    auto work = [&]() -> void {
+            for (int i = 0; i < K; ++i) { val.add(1); }
+            --running;
+        };
+
+    std::array<std::thread, N> workers { std::thread(work), std::thread(work),
+        std::thread(work), std::thread(work) };
+
+    int64_t drained = 0;
+    while (running > 0) {
+        drained += val.sumThenReset();
+    }
+
+    for (auto i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    drained += val.sumThenReset();
+    ASSERT_EQ(K * N, drained);
+}
+
 // Non-deterministic but expected to exercise concurrent updates
 TEST(Striped64Test, ConcurrencySmokeTest) {
     Striped64 val;
+    val.setMaxStripes(4);
     const int K = 100000;   // 100000 updates per
     const int N = 4;        // 4-way workers
 
@@ -91,6 +165,7 @@ TEST(Striped64Test, ConcurrencySmokeTest) {
     }
 
     ASSERT_EQ(K * N, val.value());
+    ASSERT_GE(4U, val.stripes());
 
     // Also assert reset; this test has a good chance of using the storage
     // other than base
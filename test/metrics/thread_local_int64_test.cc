@@ -0,0 +1,73 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+#include "metrics/thread_local_int64.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(ThreadLocal64Test, BasicFunctionality) {
+    ThreadLocal64 val;
+    ASSERT_EQ(0, val.value());
+
+    val.add(1);
+    ASSERT_EQ(1, val.value());
+
+    val.add(-1);
+    ASSERT_EQ(0, val.value());
+}
+
+TEST(ThreadLocal64Test, ExitedThreadsAreRetained) {
+    ThreadLocal64 val;
+    val.add(1);
+
+    std::thread([&val]() -> void { val.add(2); }).join();
+    ASSERT_EQ(3, val.value());
+
+    val.add(1);
+    ASSERT_EQ(4, val.value());
+}
+
+TEST(ThreadLocal64Test, ConcurrencySmokeTest) {
+    ThreadLocal64 val;
+    const int K = 100000;   // 100000 updates per
+    const int N = 4;        // 4-way workers
+
+    auto work = [&]() -> void {
+            for (int i = 0; i < K; ++i) { val.add(1); }
+        };
+
+    std::array<std::thread, N> workers { std::thread(work), std::thread(work),
+        std::thread(work), std::thread(work) };
+
+    for (auto i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    ASSERT_EQ(K * N, val.value());
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -0,0 +1,73 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "ccmetrics/clock.h"
+#include "metrics/tick_clock.h"
+
+namespace ccmetrics {
+namespace test {
+
+namespace {
+// The clock may be configured from static initializers in any order
+struct StaticInitialization {
+    StaticInitialization() {
+        setTickClock(ClockSource::CACHED);
+        ok = TickClock::now().time_since_epoch().count() > 0;
+        setTickClock(ClockSource::COARSE);
+    }
+    bool ok;
+} static_initialization;
+
+void checkSource(ClockSource source) {
+    setTickClock(source, std::chrono::microseconds(100));
+
+    // Readings track steady_clock to within a few scheduler ticks
+    const auto kSlack = std::chrono::milliseconds(50);
+    auto steady = std::chrono::steady_clock::now();
+    auto tick = TickClock::now();
+    ASSERT_LT(tick, steady + kSlack);
+    ASSERT_GT(tick, steady - kSlack);
+
+    // ... and advance
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto later = TickClock::now();
+    ASSERT_GT(later, tick);
+    ASSERT_GE(later - tick, std::chrono::milliseconds(50));
+}
+} // unnamed namespace
+
+TEST(TickClockTest, StaticInitialization) {
+    ASSERT_TRUE(static_initialization.ok);
+}
+
+TEST(TickClockTest, Sources) {
+    checkSource(ClockSource::STEADY);
+    checkSource(ClockSource::CACHED);
+    checkSource(ClockSource::CACHED); // Restarts the refresher
+    checkSource(ClockSource::COARSE);
+}
+
+} // test namespace
+} // ccmetrics namespace
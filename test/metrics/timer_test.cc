@@ -20,6 +20,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "ccmetrics/timer.h"
 
 namespace ccmetrics {
@@ -33,5 +35,44 @@ TEST(TimerTest, BasicFunctionality) {
     // TODO: further testing requires a manual tick / mock clock
 }
 
+TEST(TimerTest, HdrReservoir) {
+    TimerOptions options;
+    options.reservoir = ReservoirType::HDR;
+    Timer t1(options);
+    for (int i = 1; i <= 100; ++i) {
+        t1.update(i);
+    }
+    ASSERT_EQ(100, t1.count());
+    ASSERT_EQ(1, t1.snapshot().min());
+    ASSERT_EQ(100, t1.snapshot().max());
+}
+
+TEST(TimerTest, RateWindows) {
+    Timer t1;
+    ASSERT_EQ((std::vector<int>{ 60, 300, 900 }), t1.rateWindows());
+
+    TimerOptions options;
+    options.rates.rate_windows = { 10, 30 };
+    Timer t2(options);
+    ASSERT_EQ((std::vector<int>{ 10, 30 }), t2.rateWindows());
+}
+
+namespace {
+class ConstantReservoir : public Reservoir {
+public:
+    void update(int64_t) override { }
+    Snapshot snapshot() override { return Snapshot({42}, true); }
+};
+} // unnamed namespace
+
+TEST(TimerTest, CustomReservoir) {
+    TimerOptions options;
+    options.reservoir_factory = []() { return new ConstantReservoir(); };
+    Timer t1(options);
+    t1.update(1);
+    ASSERT_EQ(1, t1.count());
+    ASSERT_EQ(42, t1.snapshot().max());
+}
+
 } // test namespace
 } // ccmetrics namespace
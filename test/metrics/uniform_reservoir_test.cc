@@ -0,0 +1,63 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "metrics/uniform_reservoir.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(UniformReservoirTest, BasicFunctionality) {
+    UniformReservoir res;
+    ASSERT_EQ(0U, res.snapshot().size());
+
+    // Reservoir is big enough to hold 100 values; snapshots will be precise
+    for (int i = 0; i <= 100; ++i) {
+        res.update(i);
+    }
+
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(101U, snap.size());
+    ASSERT_EQ(0, snap.min());
+    ASSERT_EQ(100, snap.max());
+    ASSERT_EQ(50, snap.median());
+}
+
+TEST(UniformReservoirTest, Sampling) {
+    UniformReservoir res(100);
+    for (int i = 0; i < 100000; ++i) {
+        res.update(i);
+    }
+
+    // A uniform sample retains values from throughout the stream
+    Snapshot snap = res.snapshot();
+    ASSERT_EQ(100U, snap.size());
+    ASSERT_NEAR(50000, snap.median(), 15000);
+}
+
+TEST(UniformReservoirTest, InvalidArguments) {
+    ASSERT_THROW(UniformReservoir(0), std::invalid_argument);
+}
+
+} // test namespace
+} // ccmetrics namespace
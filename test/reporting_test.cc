@@ -20,9 +20,14 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <random>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "ccmetrics/metric_registry.h"
 #include "ccmetrics/porting.h"
@@ -51,6 +56,68 @@ TEST(ReportingTest, BasicFunctionality) {
     ASSERT_GT(reporter.invocations, 1);
 }
 
+namespace {
+class PeakReporter final : public PeriodicReporter {
+public:
+    explicit PeakReporter(MaxGauge *gauge) : gauge_(gauge) { }
+
+    void report() NOEXCEPT {
+        std::lock_guard<std::mutex> lock(mutex_);
+        peaks_.push_back(gauge_->value());
+        cv_.notify_all();
+    }
+
+    // @return whether a report saw `peak` before the timeout
+    bool awaitPeak(int64_t peak) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::seconds(5), [this, peak]() {
+                return std::find(peaks_.begin(), peaks_.end(), peak) !=
+                    peaks_.end();
+            });
+    }
+
+    std::vector<int64_t> peaks() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peaks_;
+    }
+private:
+    MaxGauge *gauge_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<int64_t> peaks_;
+};
+} // unnamed namespace
+
+TEST(ReportingTest, ResetWaterMarksAfterReport) {
+    MetricRegistry registry;
+    MaxGauge *gauge = registry.maxGauge("peak");
+    gauge->update(10);
+
+    PeakReporter reporter(gauge);
+    reporter.resetWaterMarksAfterReport(&registry);
+    reporter.start(std::chrono::milliseconds(10));
+    ASSERT_TRUE(reporter.awaitPeak(10));
+
+    // The first period's peak is reset after its report...
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (gauge->value() == 10 &&
+            std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_NE(10, gauge->value());
+
+    // ...so a lower peak in a later period is reported as it is
+    gauge->update(4);
+    ASSERT_TRUE(reporter.awaitPeak(4));
+    reporter.stop();
+
+    auto peaks = reporter.peaks();
+    ASSERT_EQ(10, peaks[0]);
+    for (size_t i = 1; i < peaks.size(); ++i) {
+        ASSERT_NE(10, peaks[i]);
+    }
+}
+
 TEST(ReportingTest, ConsoleReporterSmokeTest) {
     MetricRegistry registry;
     auto reporter = mkConsoleReporter(&registry);
@@ -20,6 +20,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 #include "ccmetrics/metric_registry.h"
 #include "ccmetrics/serializing/json_serializer.h"
 
@@ -43,5 +45,57 @@ TEST(SerializingTest, JsonSmoke) {
     ASSERT_NE(no_timers, ser.serialize(&reg));
 }
 
+TEST(SerializingTest, JsonRateWindows) {
+    MetricRegistry reg;
+    Serializer<JsonSerializer> ser;
+
+    TimerOptions options;
+    options.rates.rate_windows = { 30, 120 };
+    reg.timer("foo", options);
+    std::string json = ser.serialize(&reg);
+    ASSERT_NE(std::string::npos, json.find("\"rate_30s\":"));
+    ASSERT_NE(std::string::npos, json.find("\"m2_rate\":"));
+    ASSERT_EQ(std::string::npos, json.find("\"m1_rate\":"));
+}
+
+TEST(SerializingTest, JsonSums) {
+    MetricRegistry reg;
+    Serializer<JsonSerializer> ser;
+
+    Sum *s1 = reg.sum("foo");
+    s1->update(1.5);
+    ASSERT_EQ("{\"sum\":1.5}", ser.serialize(s1));
+    ASSERT_EQ("{\"counters\":{},\"timers\":{},\"sums\":{\"foo\":{\"sum\":1.5}}}",
+        ser.serialize(&reg));
+}
+
+TEST(SerializingTest, JsonGauges) {
+    MetricRegistry reg;
+    Serializer<JsonSerializer> ser;
+
+    Gauge *g1 = reg.gauge("foo");
+    g1->set(3);
+    ASSERT_EQ("{\"value\":3}", ser.serialize(g1));
+
+    DoubleGauge *g2 = reg.doubleGauge("bar", []() { return 0.5; });
+    ASSERT_EQ("{\"value\":0.5}", ser.serialize(g2));
+    ASSERT_EQ("{\"counters\":{},\"timers\":{},"
+        "\"gauges\":{\"foo\":{\"value\":3}},"
+        "\"double_gauges\":{\"bar\":{\"value\":0.5}}}",
+        ser.serialize(&reg));
+}
+
+TEST(SerializingTest, JsonWaterMarks) {
+    MetricRegistry reg;
+    Serializer<JsonSerializer> ser;
+
+    MaxGauge *g1 = reg.maxGauge("foo");
+    g1->update(7);
+    ASSERT_EQ("{\"max\":7}", ser.serialize(g1));
+    // Serializing does not reset the mark
+    ASSERT_EQ("{\"counters\":{},\"timers\":{},"
+        "\"max_gauges\":{\"foo\":{\"max\":7}}}", ser.serialize(&reg));
+}
+
 } // test namespace
 } // ccmetrics namespace
@@ -0,0 +1,116 @@
+/*
+ * Copyright (©) 2015 Nate Rosenblum
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "snapshot_kernels.h"
+
+namespace ccmetrics {
+namespace test {
+
+TEST(SnapshotKernelsTest, Empty) {
+    auto ret = kernels::sumMinMax(nullptr, 0);
+    ASSERT_EQ(0, ret.sum);
+    ASSERT_EQ(INT64_MAX, ret.min);
+    ASSERT_EQ(INT64_MIN, ret.max);
+}
+
+TEST(SnapshotKernelsTest, MatchesScalar) {
+    std::mt19937_64 gen(11);
+    std::uniform_int_distribution<int64_t> dist(-(1LL << 40), 1LL << 40);
+
+    // Sizes around the vector widths exercise the scalar tails
+    for (size_t n = 1; n < 70; ++n) {
+        std::vector<int64_t> values;
+        for (size_t i = 0; i < n; ++i) {
+            values.push_back(dist(gen));
+        }
+        auto expected = kernels::sumMinMaxScalar(values.data(), n);
+        auto actual = kernels::sumMinMax(values.data(), n);
+        ASSERT_EQ(expected.sum, actual.sum) << kernels::sumMinMaxIsa();
+        ASSERT_EQ(expected.min, actual.min) << kernels::sumMinMaxIsa();
+        ASSERT_EQ(expected.max, actual.max) << kernels::sumMinMaxIsa();
+    }
+}
+
+TEST(SnapshotKernelsTest, Extremes) {
+    std::vector<int64_t> values{3, INT64_MIN, 5, INT64_MAX, -1, 0, 7};
+    auto ret = kernels::sumMinMax(values.data(), values.size());
+    ASSERT_EQ(INT64_MIN, ret.min);
+    ASSERT_EQ(INT64_MAX, ret.max);
+    ASSERT_EQ(13, ret.sum);
+}
+
+TEST(SnapshotKernelsTest, MomentsEmpty) {
+    auto ret = kernels::moments(nullptr, 0);
+    ASSERT_EQ(INT64_MAX, ret.min);
+    ASSERT_EQ(INT64_MIN, ret.max);
+    ASSERT_EQ(0.0, ret.sum);
+    ASSERT_EQ(0.0, ret.varsum);
+}
+
+TEST(SnapshotKernelsTest, MomentsMatchScalar) {
+    std::mt19937_64 gen(13);
+    std::uniform_int_distribution<int64_t> dist(1LL << 30, 1LL << 40);
+
+    for (size_t n = 1; n < 70; ++n) {
+        std::vector<int64_t> values;
+        for (size_t i = 0; i < n; ++i) {
+            values.push_back(dist(gen));
+        }
+        auto expected = kernels::momentsScalar(values.data(), n);
+        auto actual = kernels::moments(values.data(), n);
+        ASSERT_EQ(expected.min, actual.min) << kernels::sumMinMaxIsa();
+        ASSERT_EQ(expected.max, actual.max) << kernels::sumMinMaxIsa();
+        ASSERT_NEAR(expected.sum, actual.sum, expected.sum * 1E-12)
+            << kernels::sumMinMaxIsa();
+        ASSERT_NEAR(expected.varsum, actual.varsum,
+            1E-9 * (expected.varsum + 1.0)) << kernels::sumMinMaxIsa();
+    }
+}
+
+TEST(SnapshotKernelsTest, MomentsNearLargeValues) {
+    // Offsets from the first value keep the squares small
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < 9; ++i) {
+        values.push_back((1LL << 60) + i);
+    }
+    auto ret = kernels::moments(values.data(), values.size());
+    ASSERT_EQ(60.0, ret.varsum);
+    ASSERT_EQ(1LL << 60, ret.min);
+    ASSERT_EQ((1LL << 60) + 8, ret.max);
+}
+
+TEST(SnapshotKernelsTest, MomentsWideSpan) {
+    // Spans beyond exact conversion fall back to the scalar kernel
+    std::vector<int64_t> values{3, INT64_MIN, 5, INT64_MAX, -1, 0, 7};
+    auto expected = kernels::momentsScalar(values.data(), values.size());
+    auto actual = kernels::moments(values.data(), values.size());
+    ASSERT_EQ(INT64_MIN, actual.min);
+    ASSERT_EQ(INT64_MAX, actual.max);
+    ASSERT_EQ(expected.sum, actual.sum);
+    ASSERT_EQ(expected.varsum, actual.varsum);
+}
+
+} // test namespace
+} // ccmetrics namespace
@@ -20,7 +20,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <initializer_list>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 #include "ccmetrics/snapshot.h"
 
@@ -41,7 +46,7 @@ TEST(SnapshotTest, Stdev) {
     ASSERT_EQ(0.0, mkSnap({}).stdev());
     ASSERT_EQ(0.0, mkSnap({1}).stdev());
     ASSERT_EQ(0.0, mkSnap({2, 2}).stdev());
-    ASSERT_EQ(1.0, mkSnap({1, 3, 3}).stdev());
+    ASSERT_NEAR(::sqrt(4.0 / 3.0), mkSnap({1, 3, 3}).stdev(), 1E-12);
 }
 
 TEST(SnapshotTest, Min) {
@@ -65,5 +70,175 @@ TEST(SnapshotTest, UnsortedInputsGetSorted) {
     ASSERT_EQ(2.0, snap.median());
 }
 
+TEST(SnapshotTest, Weighted) {
+    // Equivalent to {1, 3, 3, 3, 5}
+    Snapshot snap({1, 3, 5}, {1, 3, 1});
+    ASSERT_EQ(5U, snap.size());
+    ASSERT_EQ(1, snap.min());
+    ASSERT_EQ(5, snap.max());
+    ASSERT_EQ(3.0, snap.mean());
+    ASSERT_EQ(3.0, snap.median());
+    ASSERT_EQ(mkSnap({1, 3, 3, 3, 5}).get75tile(), snap.get75tile());
+    ASSERT_DOUBLE_EQ(::sqrt(2.0), snap.stdev());
+
+    ASSERT_EQ(0.0, Snapshot({}, std::vector<int64_t>()).median());
+}
+
+TEST(SnapshotTest, Summarize) {
+    const std::vector<double> quantiles{0.0, 0.5, 0.75, 0.95, 0.99, 0.999, 1.0};
+
+    auto empty = mkSnap({}).summarize(quantiles);
+    ASSERT_EQ(0U, empty.count);
+    ASSERT_EQ(0, empty.min);
+    ASSERT_EQ(0.0, empty.stdev);
+    ASSERT_EQ(quantiles.size(), empty.quantiles.size());
+    ASSERT_EQ(0.0, empty.quantiles[1]);
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int64_t> dist(-1000, 100000);
+    std::vector<int64_t> values;
+    for (int i = 0; i < 5000; ++i) {
+        values.push_back(dist(gen));
+    }
+
+    // Selection on unsorted values agrees with a fully sorted snapshot
+    Snapshot sorted(std::vector<int64_t>(values), /*sorted=*/ false);
+    Snapshot unsorted(std::move(values), /*sorted=*/ false);
+    auto summary = unsorted.summarize(quantiles);
+
+    ASSERT_EQ(sorted.size(), summary.count);
+    ASSERT_EQ(sorted.min(), summary.min);
+    ASSERT_EQ(sorted.max(), summary.max);
+    ASSERT_DOUBLE_EQ(sorted.mean(), summary.mean);
+    ASSERT_NEAR(sorted.stdev(), summary.stdev, 1E-6);
+    for (size_t i = 0; i < quantiles.size(); ++i) {
+        ASSERT_EQ(sorted.valueAt(quantiles[i]), summary.quantiles[i]);
+    }
+
+    // Individual accessors still work after a partial selection
+    ASSERT_EQ(sorted.get75tile(), unsorted.get75tile());
+    ASSERT_EQ(sorted.min(), unsorted.min());
+
+    ASSERT_THROW(unsorted.summarize({1.5}), std::invalid_argument);
+}
+
+TEST(SnapshotTest, SummarizeWeighted) {
+    Snapshot snap({1, 3, 5}, {1, 3, 1});
+    auto summary = snap.summarize({0.5, 0.75});
+    ASSERT_EQ(5U, summary.count);
+    ASSERT_EQ(1, summary.min);
+    ASSERT_EQ(5, summary.max);
+    ASSERT_EQ(3.0, summary.mean);
+    ASSERT_DOUBLE_EQ(::sqrt(2.0), summary.stdev);
+    ASSERT_EQ(snap.median(), summary.quantiles[0]);
+    ASSERT_EQ(snap.get75tile(), summary.quantiles[1]);
+}
+
+#if !defined(_WIN32)
+// Containers of snapshots move rather than copy them when growing
+static_assert(std::is_nothrow_move_constructible<Snapshot>::value,
+    "snapshot moves must not throw");
+static_assert(std::is_nothrow_move_assignable<Snapshot>::value,
+    "snapshot moves must not throw");
+#endif
+
+TEST(SnapshotTest, CopyAndMove) {
+    Snapshot snap = mkSnap({3, 1, 2});
+    Snapshot copy(snap);
+    ASSERT_EQ(2.0, copy.median());
+    ASSERT_EQ(3U, snap.size());
+
+    Snapshot moved(std::move(copy));
+    ASSERT_EQ(3, moved.max());
+
+    // Assignment replaces (and releases) the previous contents
+    Snapshot weighted({1, 3, 5}, {1, 3, 1});
+    moved = weighted;
+    ASSERT_EQ(5U, moved.size());
+    ASSERT_EQ(3.0, moved.median());
+    moved = mkSnap({7});
+    ASSERT_EQ(7, moved.min());
+    ASSERT_EQ(1U, moved.size());
+
+    Snapshot empty;
+    ASSERT_EQ(0U, empty.size());
+    empty = std::move(weighted);
+    ASSERT_EQ(5U, empty.size());
+}
+
+TEST(SnapshotTest, MovedFromIsEmpty) {
+    Snapshot snap({1, 3, 5}, {1, 3, 1});
+    Snapshot moved(std::move(snap));
+    ASSERT_EQ(5U, moved.size());
+
+    // Moved-from snapshots are valid and empty
+    ASSERT_EQ(0U, snap.size());
+    ASSERT_EQ(0.0, snap.mean());
+    ASSERT_EQ(0, snap.max());
+    ASSERT_EQ(0.0, snap.median());
+    ASSERT_EQ(0U, snap.summarize({0.5, 0.99}).count);
+    Snapshot copy(snap);
+    ASSERT_EQ(0U, copy.size());
+
+    Snapshot assigned = mkSnap({2});
+    assigned = std::move(moved);
+    ASSERT_EQ(5U, assigned.size());
+    ASSERT_EQ(0U, moved.size());
+    ASSERT_EQ(0.0, moved.stdev());
+
+    // ... and reusable
+    moved = mkSnap({4, 2});
+    ASSERT_EQ(3.0, moved.mean());
+}
+
+TEST(SnapshotTest, BuffersAreRecycled) {
+    {
+        std::vector<int64_t> values = Snapshot::buffer();
+        values.assign(1000, 1);
+        Snapshot snap(std::move(values), /*sorted=*/ true);
+    }
+
+    // Storage released by the snapshot is handed back out
+    std::vector<int64_t> buffer = Snapshot::buffer();
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_LE(1000U, buffer.capacity());
+    Snapshot::recycle(std::move(buffer));
+}
+
+TEST(SnapshotTest, Merge) {
+    ASSERT_EQ(0U, Snapshot::merge(std::vector<Snapshot>()).size());
+
+    std::vector<Snapshot> snaps;
+    snaps.push_back(mkSnap({5, 1, 9}));
+    snaps.push_back(mkSnap({}));
+    snaps.push_back(Snapshot({2, 3, 4, 10}, /*sorted=*/ true));
+
+    Snapshot merged = Snapshot::merge(snaps);
+    Snapshot expected = mkSnap({1, 2, 3, 4, 5, 9, 10});
+    ASSERT_EQ(expected.size(), merged.size());
+    ASSERT_EQ(1, merged.min());
+    ASSERT_EQ(10, merged.max());
+    ASSERT_EQ(expected.mean(), merged.mean());
+    ASSERT_EQ(expected.median(), merged.median());
+    ASSERT_EQ(expected.get75tile(), merged.get75tile());
+}
+
+TEST(SnapshotTest, MergeWeighted) {
+    std::vector<Snapshot> snaps;
+    snaps.push_back(Snapshot({1, 3, 5}, {1, 3, 1}));
+    snaps.push_back(mkSnap({3, 6}));
+
+    // Equivalent to {1, 3, 3, 3, 3, 5, 6}
+    Snapshot merged = Snapshot::merge(snaps);
+    Snapshot expected = mkSnap({1, 3, 3, 3, 3, 5, 6});
+    ASSERT_EQ(7U, merged.size());
+    ASSERT_EQ(1, merged.min());
+    ASSERT_EQ(6, merged.max());
+    ASSERT_EQ(expected.mean(), merged.mean());
+    ASSERT_EQ(expected.median(), merged.median());
+    ASSERT_EQ(expected.get75tile(), merged.get75tile());
+    ASSERT_EQ(expected.get99tile(), merged.get99tile());
+}
+
 } // test namespace
 } // ccmetrics namespace